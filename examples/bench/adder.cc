@@ -0,0 +1,236 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <array>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+#include "../../rinku/logic/logic.h"
+#include "../../rinku/util/splitter.h"
+#include "../../rinku/util/joiner.h"
+
+// Gate-level benchmark: a 32-bit ripple-carry adder built from individual
+// Logic gates, fed by two counters and checked against the native sum on
+// every clock cycle. Pass "shuffled" to add the gates to the system in a
+// random order, like a netlist that was read from a file. Any number of
+// copies of the adder can be instantiated to build large netlists, and these
+// can be settled on multiple threads. Pass "fused" as the last argument to
+// evaluate the gates as fused logic blocks.
+
+using namespace Rinku;
+using namespace Rinku::Util;
+using namespace Rinku::Logic;
+
+constexpr size_t BITS = 32;
+
+// ------------ OPERAND --------------
+OUTPUT(OP_OUT, 32);
+SIGNAL_LIST(OperandOutputs, OP_OUT);
+
+class Operand: MODULE(OperandOutputs) {
+  signal_t const increment;
+  signal_t value = 0;
+public:
+  EVENT_DRIVEN();
+  
+  Operand(signal_t inc):
+    increment(inc)
+  {}
+  
+  ON_CLOCK_FALLING() {
+    value += increment;
+    STATE_CHANGED();
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(OP_OUT, value);
+  }
+
+  RESET() {
+    value = 0;
+  }
+};
+
+// ------------ CHECKER --------------
+INPUT(CHK_A, 32);
+INPUT(CHK_B, 32);
+INPUT(CHK_SUM, 32);
+OUTPUT(CHK_ERR, 1);
+OUTPUT(CHK_DONE, 1);
+
+SIGNAL_LIST(CheckerInputs, CHK_A, CHK_B, CHK_SUM);
+SIGNAL_LIST(CheckerOutputs, CHK_ERR, CHK_DONE);
+
+class Checker: MODULE(CheckerInputs, CheckerOutputs) {
+  size_t const cycles;
+  size_t count = 0;
+  bool error = false;
+public:
+  EVENT_DRIVEN();
+  
+  Checker(size_t n):
+    cycles(n)
+  {}
+
+  ON_CLOCK_RISING() {
+    signal_t const expected = (GET_INPUT(CHK_A) + GET_INPUT(CHK_B)) & CHK_SUM::Mask;
+    bool const wrong = (GET_INPUT(CHK_SUM) != expected);
+    ++count;
+    if ((wrong && !error) || count == cycles) {
+      STATE_CHANGED();
+    }
+    error = error || wrong;
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(CHK_ERR, error);
+    SET_OUTPUT(CHK_DONE, count >= cycles);
+  }
+
+  RESET() {
+    count = 0;
+    error = false;
+  }
+};
+
+// ------------ SYSTEM --------------
+class RippleCarryAdder: public System {
+  struct FullAdder {
+    Xor *x1, *x2;
+    And *a1, *a2;
+    Or *o1;
+  };
+
+  std::vector<std::array<FullAdder, BITS>> _copies;
+  
+public:
+  RippleCarryAdder(size_t cycles, bool shuffled, size_t copies = 1, size_t threads = 1, bool fused = false):
+    _copies(copies)
+  {
+    enableParallelSettle(threads);
+    fuseLogic(fused);
+
+    auto &a = addModule<Operand>(0x00000001);
+    auto &b = addModule<Operand>(0x9e3779b9);
+    addGates(shuffled);
+
+    for (size_t copy = 0; copy != copies; ++copy) {
+      auto &aSplit = addModule<Splitter<BITS>>();
+      auto &bSplit = addModule<Splitter<BITS>>();
+      auto &sum = addModule<Joiner<BITS>>();
+      auto &check = addModule<Checker>(cycles);
+    
+      CONNECT_MOD(aSplit, SPLITTER_IN, a, OP_OUT);
+      CONNECT_MOD(bSplit, SPLITTER_IN, b, OP_OUT);
+      connectBit<0>(_copies[copy], aSplit, bSplit, sum);
+
+      CONNECT_MOD(check, CHK_A, a, OP_OUT);
+      CONNECT_MOD(check, CHK_B, b, OP_OUT);
+      CONNECT_MOD(check, CHK_SUM, sum, JOINER_OUT);
+      connectError<CHK_ERR>(check);
+      connectExit<CHK_DONE>(check);
+    }
+    init();
+  }
+
+private:
+  void addGates(bool shuffled) {
+    std::vector<size_t> order(5 * BITS * _copies.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (shuffled) {
+      std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    }
+    
+    for (size_t idx: order) {
+      FullAdder &fa = _copies[idx / (5 * BITS)][(idx / 5) % BITS];
+      switch (idx % 5) {
+      case 0: fa.x1 = &addModule<Xor>(); break;
+      case 1: fa.x2 = &addModule<Xor>(); break;
+      case 2: fa.a1 = &addModule<And>(); break;
+      case 3: fa.a2 = &addModule<And>(); break;
+      case 4: fa.o1 = &addModule<Or>();  break;
+      }
+    }
+  }
+  
+  // Full adder per bit: S = A ^ B ^ Cin, Cout = (A & B) | ((A ^ B) & Cin)
+  template <size_t I>
+  void connectBit(std::array<FullAdder, BITS> &bits, Splitter<BITS> &aSplit, Splitter<BITS> &bSplit, Joiner<BITS> &sum) {
+    if constexpr (I < BITS) {
+      using A = std::tuple_element_t<I, std::tuple<SPLITTER_OUT_0, SPLITTER_OUT_1, SPLITTER_OUT_2, SPLITTER_OUT_3,
+						   SPLITTER_OUT_4, SPLITTER_OUT_5, SPLITTER_OUT_6, SPLITTER_OUT_7,
+						   SPLITTER_OUT_8, SPLITTER_OUT_9, SPLITTER_OUT_10, SPLITTER_OUT_11,
+						   SPLITTER_OUT_12, SPLITTER_OUT_13, SPLITTER_OUT_14, SPLITTER_OUT_15,
+						   SPLITTER_OUT_16, SPLITTER_OUT_17, SPLITTER_OUT_18, SPLITTER_OUT_19,
+						   SPLITTER_OUT_20, SPLITTER_OUT_21, SPLITTER_OUT_22, SPLITTER_OUT_23,
+						   SPLITTER_OUT_24, SPLITTER_OUT_25, SPLITTER_OUT_26, SPLITTER_OUT_27,
+						   SPLITTER_OUT_28, SPLITTER_OUT_29, SPLITTER_OUT_30, SPLITTER_OUT_31>>;
+      using S = std::tuple_element_t<I, std::tuple<JOINER_IN_0, JOINER_IN_1, JOINER_IN_2, JOINER_IN_3,
+						   JOINER_IN_4, JOINER_IN_5, JOINER_IN_6, JOINER_IN_7,
+						   JOINER_IN_8, JOINER_IN_9, JOINER_IN_10, JOINER_IN_11,
+						   JOINER_IN_12, JOINER_IN_13, JOINER_IN_14, JOINER_IN_15,
+						   JOINER_IN_16, JOINER_IN_17, JOINER_IN_18, JOINER_IN_19,
+						   JOINER_IN_20, JOINER_IN_21, JOINER_IN_22, JOINER_IN_23,
+						   JOINER_IN_24, JOINER_IN_25, JOINER_IN_26, JOINER_IN_27,
+						   JOINER_IN_28, JOINER_IN_29, JOINER_IN_30, JOINER_IN_31>>;
+
+      FullAdder &fa = bits[I];
+      CONNECT_MOD(*fa.x1, XOR_IN_A, aSplit, A);
+      CONNECT_MOD(*fa.x1, XOR_IN_B, bSplit, A);
+      CONNECT_MOD(*fa.a1, AND_IN_A, aSplit, A);
+      CONNECT_MOD(*fa.a1, AND_IN_B, bSplit, A);
+
+      CONNECT_MOD(*fa.x2, XOR_IN_A, *fa.x1, XOR_OUT);
+      CONNECT_MOD(*fa.a2, AND_IN_A, *fa.x1, XOR_OUT);
+      if constexpr (I > 0) {
+	CONNECT_MOD(*fa.x2, XOR_IN_B, *bits[I - 1].o1, OR_OUT);
+	CONNECT_MOD(*fa.a2, AND_IN_B, *bits[I - 1].o1, OR_OUT);
+      }
+      else {
+	CONNECT_CONST(*fa.x2, XOR_IN_B, 0);
+	CONNECT_CONST(*fa.a2, AND_IN_B, 0);
+      }
+
+      CONNECT_MOD(*fa.o1, OR_IN_A, *fa.a1, AND_OUT);
+      CONNECT_MOD(*fa.o1, OR_IN_B, *fa.a2, AND_OUT);
+      CONNECT_MOD(sum, S, *fa.x2, XOR_OUT);
+
+      connectBit<I + 1>(bits, aSplit, bSplit, sum);
+    }
+  }
+};
+
+int main(int argc, char **argv) try {
+  size_t const cycles = (argc > 1) ? std::stoul(argv[1]) : 200'000;
+  bool const shuffled = (argc > 2) && (std::string(argv[2]) == "shuffled");
+  size_t const copies = (argc > 3) ? std::stoul(argv[3]) : 1;
+  size_t const threads = (argc > 4) ? std::stoul(argv[4]) : 1;
+  bool const fused = (argc > 5) && (std::string(argv[5]) == "fused");
+
+  RippleCarryAdder sys(cycles, shuffled, copies, threads, fused);
+  sys.resetStatistics();
+  
+  auto const start = std::chrono::steady_clock::now();
+  size_t count = 0;
+  while (sys.step()) {
+    ++count;
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  double const seconds = std::chrono::duration<double>(stop - start).count();
+  auto const &stats = sys.statistics();
+  std::cout << "Modules:               " << sys.moduleNames().size() << '\n'
+	    << "Cycles:                " << count << '\n'
+	    << "Result:                " << (sys.getInput<SYS_ERR>() ? "WRONG SUM" : "OK") << '\n'
+	    << "Cycles/sec:            " << (count / seconds) << '\n'
+	    << "Schedule levels:       " << stats.levels << '\n'
+	    << "Modules in loops:      " << stats.cyclicModules << '\n'
+	    << "Parallel levels:       " << stats.parallelLevels << '\n'
+	    << "Fused gates:           " << stats.fusedGates << " in " << stats.logicBlocks << " blocks\n"
+	    << "Updates per half-step: " << (count ? double(stats.updates) / (2 * count) : 0.0) << '\n';
+  
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <chrono>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+
+// Input-heavy benchmark: a bank of RegisterDrivers from the bfcpu example, all
+// driven by the same counter. Each driver reads all five of its inputs on every
+// update. The register-select inputs each have a single driver, INC is driven
+// by an inverted counter-bit, and DEC is tied to a constant. Every fourth
+// driver has an additional driver on RS0, so that a few inputs have more than
+// one driver.
+
+using namespace Rinku;
+
+#include "../bfcpu/registerdriver.h"
+
+// ------------ COUNTER --------------
+OUTPUT(CNT_B0, 1);
+OUTPUT(CNT_B1, 1);
+OUTPUT(CNT_B2, 1);
+OUTPUT(CNT_B3, 1);
+OUTPUT(CNT_DONE, 1);
+SIGNAL_LIST(CounterOutputs, CNT_B0, CNT_B1, CNT_B2, CNT_B3, CNT_DONE);
+
+class Counter: MODULE(CounterOutputs) {
+  size_t const cycles;
+  size_t count = 0;
+public:
+  EVENT_DRIVEN();
+
+  Counter(size_t n):
+    cycles(n)
+  {}
+
+  ON_CLOCK_FALLING() {
+    ++count;
+    STATE_CHANGED();
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(CNT_B0, count >> 0);
+    SET_OUTPUT(CNT_B1, count >> 1);
+    SET_OUTPUT(CNT_B2, count >> 2);
+    SET_OUTPUT(CNT_B3, count >> 3);
+    SET_OUTPUT(CNT_DONE, count >= cycles);
+  }
+
+  RESET() {
+    count = 0;
+  }
+};
+
+// ------------ SYSTEM --------------
+class DecoderBank: public System {
+public:
+  DecoderBank(size_t cycles, size_t drivers) {
+    auto &counter = addModule<Counter>(cycles);
+    for (size_t idx = 0; idx != drivers; ++idx) {
+      auto &rd = addModule<RegisterDriver>();
+      CONNECT_MOD(rd, RD_RS0, counter, CNT_B0);
+      CONNECT_MOD(rd, RD_RS1, counter, CNT_B1);
+      CONNECT_MOD(rd, RD_RS2, counter, CNT_B2);
+      CONNECT_MOD(rd, RD_INC, counter, NOT(CNT_B3));
+      CONNECT_CONST(rd, RD_DEC, 0);
+      if (idx % 4 == 0) CONNECT_MOD(rd, RD_RS0, counter, CNT_B3);
+    }
+    connectExit<CNT_DONE>(counter);
+    init();
+  }
+};
+
+int main(int argc, char **argv) try {
+  size_t const cycles = (argc > 1) ? std::stoul(argv[1]) : 20'000;
+  size_t const drivers = (argc > 2) ? std::stoul(argv[2]) : 1'000;
+
+  DecoderBank sys(cycles, drivers);
+  sys.resetStatistics();
+
+  auto const start = std::chrono::steady_clock::now();
+  size_t count = 0;
+  while (sys.step()) {
+    ++count;
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  double const seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << "Drivers:               " << drivers << '\n'
+	    << "Cycles:                " << count << '\n'
+	    << "Cycles/sec:            " << (count / seconds) << '\n'
+	    << "Updates per half-step: " << (count ? double(sys.statistics().updates) / (2 * count) : 0.0) << '\n';
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <chrono>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+
+// Mostly idle system: a single active counter next to a large bank of
+// peripherals that are never selected. The same system is built twice, once
+// from event-driven peripherals and once from peripherals that do not report
+// their state changes, to show the cost of updating idle modules. The clock
+// handlers of the peripherals can be dispatched over multiple threads.
+
+using namespace Rinku;
+
+// ------------ COUNTER --------------
+OUTPUT(CNT_DONE, 1);
+SIGNAL_LIST(CounterOutputs, CNT_DONE);
+
+class Counter: MODULE(CounterOutputs) {
+  size_t const cycles;
+  size_t count = 0;
+public:
+  EVENT_DRIVEN();
+
+  Counter(size_t n):
+    cycles(n)
+  {}
+
+  ON_CLOCK_RISING() {
+    if (++count == cycles) {
+      STATE_CHANGED();
+    }
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(CNT_DONE, count >= cycles);
+  }
+
+  RESET() {
+    count = 0;
+  }
+};
+
+// ------------ PERIPHERAL --------------
+INPUT(PER_SEL, 1);
+OUTPUT(PER_OUT, 16);
+SIGNAL_LIST(PeripheralInputs, PER_SEL);
+SIGNAL_LIST(PeripheralOutputs, PER_OUT);
+
+template <bool Event>
+class Peripheral: MODULE(PeripheralInputs, PeripheralOutputs) {
+  signal_t value = 0;
+public:
+  static constexpr bool EventDriven = Event;
+
+  ON_CLOCK_FALLING() {
+    if (GET_INPUT(PER_SEL)) {
+      ++value;
+      STATE_CHANGED();
+    }
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(PER_OUT, value);
+  }
+
+  RESET() {
+    value = 0;
+  }
+};
+
+// ------------ SYSTEM --------------
+template <bool Event>
+class IdleSystem: public System {
+public:
+  IdleSystem(size_t cycles, size_t peripherals, size_t threads) {
+    auto &counter = addModule<Counter>(cycles);
+    for (size_t idx = 0; idx != peripherals; ++idx) {
+      auto &p = addModule<Peripheral<Event>>();
+      p.template connect<PER_SEL, 0>();
+    }
+    connectExit<CNT_DONE>(counter);
+    enableParallelClock(threads);
+    init();
+  }
+};
+
+template <bool Event>
+void run(size_t cycles, size_t peripherals, size_t threads) {
+  IdleSystem<Event> sys(cycles, peripherals, threads);
+  sys.resetStatistics();
+
+  auto const start = std::chrono::steady_clock::now();
+  size_t count = 0;
+  while (sys.step()) {
+    ++count;
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  double const seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << (Event ? "Event-driven:  " : "Always update: ")
+	    << (count / seconds) << " cycles/sec, "
+	    << (count ? double(sys.statistics().updates) / (2 * count) : 0.0) << " updates per half-step\n";
+}
+
+int main(int argc, char **argv) try {
+  size_t const cycles = (argc > 1) ? std::stoul(argv[1]) : 20'000;
+  size_t const peripherals = (argc > 2) ? std::stoul(argv[2]) : 1'000;
+  size_t const threads = (argc > 3) ? std::stoul(argv[3]) : 1;
+
+  std::cout << "Peripherals:   " << peripherals << '\n';
+  run<false>(cycles, peripherals, threads);
+  run<true>(cycles, peripherals, threads);
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+}
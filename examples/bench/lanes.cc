@@ -0,0 +1,194 @@
+#include <iostream>
+#include <chrono>
+#include <array>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+#include "../../rinku/logic/logic.h"
+
+// Bit-parallel benchmark: exhaustively tests an 8-bit ripple-carry adder with
+// carry-in (17 inputs, 131072 input combinations) built from Logic gates. The
+// adder is built twice: once from the scalar gates, which test one input
+// combination per clock cycle, and once from the Logic::Lanes gates, which
+// test 64 combinations per clock cycle. Every sum is checked in both runs.
+
+using namespace Rinku;
+
+constexpr size_t BITS = 8;
+constexpr size_t INPUTS = 2 * BITS + 1;
+
+// ------------ STIMULUS --------------
+// Drives input bit 'input' of the combination under test, which advances on
+// every falling clock edge.
+OUTPUT(STIM_OUT, 64);
+SIGNAL_LIST(StimulusOutputs, STIM_OUT);
+
+class Stimulus: MODULE(StimulusOutputs) {
+  size_t const input;
+  bool const lanes;
+  size_t batch = 0;
+public:
+  EVENT_DRIVEN();
+
+  Stimulus(size_t in, bool parallel):
+    input(in),
+    lanes(parallel)
+  {}
+
+  ON_CLOCK_FALLING() {
+    ++batch;
+    STATE_CHANGED();
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(STIM_OUT, lanes ? Logic::Lanes::exhaustive(input, batch) : (batch >> input) & 1);
+  }
+
+  RESET() {
+    batch = 0;
+  }
+};
+
+// ------------ GATES --------------
+struct Scalar {
+  static constexpr size_t Lanes = 1;
+  static constexpr size_t Batches = size_t(1) << INPUTS;
+
+  using Xor = Logic::Xor;
+  using And = Logic::And;
+  using Or = Logic::Or;
+  using XOR_IN_A = Logic::XOR_IN_A;
+  using XOR_IN_B = Logic::XOR_IN_B;
+  using XOR_OUT = Logic::XOR_OUT;
+  using AND_IN_A = Logic::AND_IN_A;
+  using AND_IN_B = Logic::AND_IN_B;
+  using AND_OUT = Logic::AND_OUT;
+  using OR_IN_A = Logic::OR_IN_A;
+  using OR_IN_B = Logic::OR_IN_B;
+  using OR_OUT = Logic::OR_OUT;
+};
+
+struct Parallel {
+  static constexpr size_t Lanes = Logic::Lanes::N;
+  static constexpr size_t Batches = Logic::Lanes::batches(INPUTS);
+
+  using Xor = Logic::Lanes::Xor;
+  using And = Logic::Lanes::And;
+  using Or = Logic::Lanes::Or;
+  using XOR_IN_A = Logic::Lanes::XOR_IN_A;
+  using XOR_IN_B = Logic::Lanes::XOR_IN_B;
+  using XOR_OUT = Logic::Lanes::XOR_OUT;
+  using AND_IN_A = Logic::Lanes::AND_IN_A;
+  using AND_IN_B = Logic::Lanes::AND_IN_B;
+  using AND_OUT = Logic::Lanes::AND_OUT;
+  using OR_IN_A = Logic::Lanes::OR_IN_A;
+  using OR_IN_B = Logic::Lanes::OR_IN_B;
+  using OR_OUT = Logic::Lanes::OR_OUT;
+};
+
+// ------------ SYSTEM --------------
+// Full adder per bit: S = A ^ B ^ Cin, Cout = (A & B) | ((A ^ B) & Cin)
+template <typename G>
+class Adder: public System {
+  struct FullAdder {
+    typename G::Xor *x1, *x2;
+    typename G::And *a1, *a2;
+    typename G::Or *o1;
+  };
+
+  std::array<FullAdder, BITS> _bits;
+
+public:
+  Adder() {
+    std::array<Stimulus*, INPUTS> stim;
+    for (size_t input = 0; input != INPUTS; ++input) {
+      stim[input] = &addModule<Stimulus>(input, G::Lanes > 1);
+    }
+
+    for (size_t bit = 0; bit != BITS; ++bit) {
+      FullAdder &fa = _bits[bit];
+      fa.x1 = &addModule<typename G::Xor>();
+      fa.x2 = &addModule<typename G::Xor>();
+      fa.a1 = &addModule<typename G::And>();
+      fa.a2 = &addModule<typename G::And>();
+      fa.o1 = &addModule<typename G::Or>();
+
+      Stimulus &a = *stim[bit];
+      Stimulus &b = *stim[BITS + bit];
+      fa.x1->template connect<typename G::XOR_IN_A, STIM_OUT>(a);
+      fa.x1->template connect<typename G::XOR_IN_B, STIM_OUT>(b);
+      fa.a1->template connect<typename G::AND_IN_A, STIM_OUT>(a);
+      fa.a1->template connect<typename G::AND_IN_B, STIM_OUT>(b);
+
+      fa.x2->template connect<typename G::XOR_IN_A, typename G::XOR_OUT>(*fa.x1);
+      fa.a2->template connect<typename G::AND_IN_A, typename G::XOR_OUT>(*fa.x1);
+      if (bit > 0) {
+	fa.x2->template connect<typename G::XOR_IN_B, typename G::OR_OUT>(*_bits[bit - 1].o1);
+	fa.a2->template connect<typename G::AND_IN_B, typename G::OR_OUT>(*_bits[bit - 1].o1);
+      }
+      else {
+	fa.x2->template connect<typename G::XOR_IN_B, STIM_OUT>(*stim[2 * BITS]);
+	fa.a2->template connect<typename G::AND_IN_B, STIM_OUT>(*stim[2 * BITS]);
+      }
+
+      fa.o1->template connect<typename G::OR_IN_A, typename G::AND_OUT>(*fa.a1);
+      fa.o1->template connect<typename G::OR_IN_B, typename G::AND_OUT>(*fa.a2);
+    }
+    init();
+  }
+
+  // Checks the sums of all lanes of the current batch
+  bool check(size_t batch) const {
+    for (size_t l = 0; l != G::Lanes; ++l) {
+      size_t const combination = batch * G::Lanes + l;
+      size_t const a = combination & 0xff;
+      size_t const b = (combination >> BITS) & 0xff;
+      size_t const cin = combination >> (2 * BITS);
+
+      size_t sum = Logic::Lanes::lane(_bits[BITS - 1].o1->template getOutput<typename G::OR_OUT>(), l) << BITS;
+      for (size_t bit = 0; bit != BITS; ++bit) {
+	sum |= size_t(Logic::Lanes::lane(_bits[bit].x2->template getOutput<typename G::XOR_OUT>(), l)) << bit;
+      }
+      if (sum != a + b + cin) return false;
+    }
+    return true;
+  }
+};
+
+template <typename G>
+double exhaustive(bool &ok, size_t &updates) {
+  Adder<G> sys;
+  sys.resetStatistics();
+
+  ok = true;
+  auto const start = std::chrono::steady_clock::now();
+  for (size_t batch = 0; batch != G::Batches; ++batch) {
+    ok = sys.check(batch) && ok;
+    sys.step();
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  updates = sys.statistics().updates;
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+int main() try {
+  bool scalarOk, parallelOk;
+  size_t scalarUpdates, parallelUpdates;
+  double const scalarTime = exhaustive<Scalar>(scalarOk, scalarUpdates);
+  double const parallelTime = exhaustive<Parallel>(parallelOk, parallelUpdates);
+
+  size_t const vectors = size_t(1) << INPUTS;
+  std::cout << "Input combinations:    " << vectors << '\n'
+	    << "Clock cycles:          " << Scalar::Batches << " (scalar), " << Parallel::Batches << " (lanes)\n"
+	    << "Module updates:        " << scalarUpdates << " (scalar), " << parallelUpdates << " (lanes)\n"
+	    << "Vectors/sec:           " << (vectors / scalarTime) << " (scalar), " << (vectors / parallelTime) << " (lanes)\n"
+	    << "Speedup:               " << (scalarTime / parallelTime) << '\n'
+	    << "Result:                " << ((scalarOk && parallelOk) ? "OK" : "WRONG SUM") << '\n';
+  return (scalarOk && parallelOk) ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
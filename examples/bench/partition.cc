@@ -0,0 +1,147 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+#include "../../rinku/logic/logic.h"
+
+// Partitioning benchmark: a synthetic netlist of Xor gates arranged in a grid
+// that is WIDTH columns wide and DEPTH rows deep. Every gate combines the gate
+// above it with the gate above and to the right of it (wrapping around at the
+// edge), and a row of registers feeds the last row back into the first on every
+// clock cycle. The grid is deep and every gate only talks to its neighbours,
+// so a good partition cuts it into vertical strips. The same netlist is
+// simulated serially and partitioned into a number of clusters, and the final
+// states of both are compared.
+
+using namespace Rinku;
+using namespace Rinku::Logic;
+
+// ------------ REGISTER --------------
+INPUT(REG_IN, 1);
+OUTPUT(REG_OUT, 1);
+SIGNAL_LIST(RegisterInputs, REG_IN);
+SIGNAL_LIST(RegisterOutputs, REG_OUT);
+
+class Register: MODULE(RegisterInputs, RegisterOutputs) {
+  signal_t const initial;
+  signal_t value;
+public:
+  EVENT_DRIVEN();
+
+  Register(signal_t init):
+    initial(init),
+    value(init)
+  {}
+
+  ON_CLOCK_RISING() {
+    signal_t const next = GET_INPUT(REG_IN);
+    if (next != value) {
+      value = next;
+      STATE_CHANGED();
+    }
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(REG_OUT, value);
+  }
+
+  RESET() {
+    value = initial;
+  }
+};
+
+// ------------ SYSTEM --------------
+class XorGrid: public System {
+public:
+  XorGrid(size_t width, size_t depth, size_t clusters) {
+    std::vector<Register*> regs;
+    for (size_t x = 0; x != width; ++x) {
+      regs.push_back(&addModule<Register>((x * x + 3 * x) % 7 < 3));
+    }
+
+    std::vector<Xor*> previous;
+    for (size_t d = 0; d != depth; ++d) {
+      std::vector<Xor*> row;
+      for (size_t x = 0; x != width; ++x) {
+	row.push_back(&addModule<Xor>());
+      }
+      for (size_t x = 0; x != width; ++x) {
+	size_t const right = (x + 1) % width;
+	if (d == 0) {
+	  CONNECT_MOD(*row[x], XOR_IN_A, *regs[x], REG_OUT);
+	  CONNECT_MOD(*row[x], XOR_IN_B, *regs[right], REG_OUT);
+	}
+	else {
+	  CONNECT_MOD(*row[x], XOR_IN_A, *previous[x], XOR_OUT);
+	  CONNECT_MOD(*row[x], XOR_IN_B, *previous[right], XOR_OUT);
+	}
+      }
+      previous = std::move(row);
+    }
+
+    for (size_t x = 0; x != width; ++x) {
+      CONNECT_MOD(*regs[x], REG_IN, *previous[(x + width / 2) % width], XOR_OUT);
+    }
+
+    partition(clusters);
+    init();
+  }
+};
+
+double simulate(XorGrid &sys, size_t cycles) {
+  sys.resetStatistics();
+  auto const start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count != cycles; ++count) {
+    sys.step();
+  }
+  auto const stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char **argv) try {
+  size_t const cycles = (argc > 1) ? std::stoul(argv[1]) : 50;
+  size_t const clusters = (argc > 2) ? std::stoul(argv[2]) : 4;
+  size_t const width = (argc > 3) ? std::stoul(argv[3]) : 1'000;
+  size_t const depth = (argc > 4) ? std::stoul(argv[4]) : 100;
+  if (clusters < 2) {
+    std::cerr << "The number of clusters must be at least 2.\n";
+    return 1;
+  }
+
+  XorGrid serial(width, depth, 1);
+  XorGrid partitioned(width, depth, clusters);
+
+  double const serialTime = simulate(serial, cycles);
+  double const partitionedTime = simulate(partitioned, cycles);
+
+  auto const a = serial.signals();
+  auto const b = partitioned.signals();
+  bool const same = std::equal(a.begin(), a.end(), b.begin(), b.end());
+
+  auto const &p = partitioned.partitioning();
+  size_t const largest = *std::max_element(p.sizes.begin(), p.sizes.end());
+  size_t const smallest = *std::min_element(p.sizes.begin(), p.sizes.end());
+  double const average = double(width * (depth + 1)) / p.sizes.size();
+
+  std::cout << "Modules:               " << width * (depth + 1) << '\n'
+	    << "Clusters:              " << p.sizes.size() << " (" << smallest << " - " << largest << " modules, "
+	    << "largest is " << (largest / average) << "x average)\n"
+	    << "Cut connections:       " << p.cutConnections << " of " << p.connections
+	    << " (" << (100.0 * p.cutConnections / p.connections) << "%)\n"
+	    << "Boundary signals:      " << p.boundarySignals << '\n'
+	    << "Rounds per settle:     " << double(partitioned.statistics().rounds) / partitioned.statistics().settles << '\n'
+	    << "Updates per half-step: " << double(serial.statistics().updates) / (2 * cycles) << " (serial), "
+	    << double(partitioned.statistics().updates) / (2 * cycles) << " (partitioned)\n"
+	    << "Cycles/sec:            " << (cycles / serialTime) << " (serial), "
+	    << (cycles / partitionedTime) << " (partitioned)\n"
+	    << "Speedup:               " << (serialTime / partitionedTime) << '\n'
+	    << "Result:                " << (same ? "OK" : "DIFFERENT STATES") << '\n';
+  return same ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
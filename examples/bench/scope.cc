@@ -0,0 +1,144 @@
+#include <iostream>
+#include <chrono>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+
+// Scope sampling benchmark: a number of chains of inverters, each driven by a
+// source that toggles with a period of its own, are monitored by one scope per
+// chain (1000 signals in total by default). Most half steps leave all of them
+// unchanged. The system is run three times: without scopes, with scopes, and
+// with scopes while also inspecting every monitored signal after every half
+// step, which is what sampling cost before the scopes only looked at the
+// signals that were reported as changed. The number of signals inspected per
+// cycle is taken from the statistics of the system.
+
+using namespace Rinku;
+
+// ------------ SOURCE --------------
+OUTPUT(SRC_OUT, 1);
+SIGNAL_LIST(SourceOutputs, SRC_OUT);
+
+class Source: MODULE(SourceOutputs) {
+  size_t const period;
+  size_t count = 0;
+  signal_t value = 0;
+public:
+  EVENT_DRIVEN();
+
+  Source(size_t p):
+    period(p)
+  {}
+
+  ON_CLOCK_RISING() {
+    if (++count == period) {
+      count = 0;
+      value ^= 1;
+      STATE_CHANGED();
+    }
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(SRC_OUT, value);
+  }
+
+  RESET() {
+    count = 0;
+    value = 0;
+  }
+};
+
+// ------------ INVERTER --------------
+INPUT(INV_IN, 1);
+OUTPUT(INV_OUT, 1);
+SIGNAL_LIST(InverterInputs, INV_IN);
+SIGNAL_LIST(InverterOutputs, INV_OUT);
+
+class Inverter: MODULE(InverterInputs, InverterOutputs) {
+public:
+  EVENT_DRIVEN();
+
+  UPDATE() {
+    SET_OUTPUT(INV_OUT, !GET_INPUT(INV_IN));
+  }
+};
+
+// ------------ SYSTEM --------------
+class Chains: public System {
+public:
+  std::vector<VcdScope*> scopes;
+
+  Chains(size_t chains, size_t length, bool monitored) {
+    for (size_t chain = 0; chain != chains; ++chain) {
+      std::string const name = "chain" + std::to_string(chain);
+      auto &source = addModule<Source>(name + "_src", 100 + 17 * chain);
+      VcdScope *scope = monitored ? &addScope(name) : nullptr;
+      if (scope) scopes.push_back(scope);
+
+      Inverter *previous = nullptr;
+      for (size_t idx = 0; idx != length; ++idx) {
+	auto &inv = addModule<Inverter>(name + "_inv" + std::to_string(idx));
+	if (previous) inv.connect<INV_IN, INV_OUT>(*previous);
+	else inv.connect<INV_IN, SRC_OUT>(source);
+	if (scope) scope->monitor(inv);
+	previous = &inv;
+      }
+    }
+    init();
+  }
+};
+
+template <typename Function>
+double measure(Function &&fun) {
+  auto const start = std::chrono::steady_clock::now();
+  fun();
+  auto const stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char **argv) try {
+  size_t const cycles = (argc > 1) ? std::stoul(argv[1]) : 1'000'000;
+  size_t const chains = (argc > 2) ? std::stoul(argv[2]) : 10;
+  size_t const length = (argc > 3) ? std::stoul(argv[3]) : 100;
+
+  Chains bare(chains, length, false);
+  double const bareTime = measure([&] {
+    for (size_t cycle = 0; cycle != cycles; ++cycle) bare.step();
+  });
+
+  Chains watched(chains, length, true);
+  double const watchedTime = measure([&] {
+    for (size_t cycle = 0; cycle != cycles; ++cycle) watched.step();
+  });
+  double const samples = double(watched.statistics().samples) / cycles;
+
+  // Sampling the scopes again right after the system did finds no changes,
+  // but inspects every signal
+  Chains scanned(chains, length, true);
+  double const scannedTime = measure([&] {
+    for (size_t tick = 0; tick != 2 * cycles; ++tick) {
+      scanned.halfStep();
+      for (VcdScope *scope: scanned.scopes) scope->sample(tick);
+    }
+  });
+
+  bool const same = watched.vcd().substr(watched.vcd().find("$scope")) ==
+    scanned.vcd().substr(scanned.vcd().find("$scope"));
+
+  double const watchedCost = watchedTime - bareTime;
+  double const scannedCost = scannedTime - bareTime;
+  std::cout << "Monitored signals:         " << (chains * length) << '\n'
+	    << "Clock cycles:              " << cycles << '\n'
+	    << "Signals inspected / cycle: " << samples << '\n'
+	    << "Without scopes:            " << bareTime << " s\n"
+	    << "Change-driven sampling:    " << watchedTime << " s (+" << watchedCost << " s)\n"
+	    << "Inspecting every signal:   " << scannedTime << " s (+" << scannedCost << " s)\n"
+	    << "Monitoring speedup:        " << (scannedCost / watchedCost) << '\n'
+	    << "Result:                    " << (same ? "SAME" : "DIFFERENT") << '\n';
+  return same ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <chrono>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+#include "../../rinku/util/splitter.h"
+#include "../../rinku/util/joiner.h"
+
+// Splitter-heavy benchmark: a 64-bit counter is passed through a chain of
+// Splitter<64>/Joiner<64> pairs, connected bit by bit, and the value at the
+// end of the chain is checked against the counter on every clock cycle. Only
+// the lowest few bits of the counter change on most cycles, so most of the 64
+// outputs of each splitter stay the same.
+
+using namespace Rinku;
+using namespace Rinku::Util;
+
+// ------------ COUNTER --------------
+OUTPUT(CNT_OUT, 64);
+SIGNAL_LIST(CounterOutputs, CNT_OUT);
+
+class Counter: MODULE(CounterOutputs) {
+  signal_t value = 0;
+public:
+  EVENT_DRIVEN();
+
+  ON_CLOCK_FALLING() {
+    ++value;
+    STATE_CHANGED();
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(CNT_OUT, value);
+  }
+
+  RESET() {
+    value = 0;
+  }
+};
+
+// ------------ CHECKER --------------
+INPUT(CHK_EXPECTED, 64);
+INPUT(CHK_ACTUAL, 64);
+OUTPUT(CHK_ERR, 1);
+OUTPUT(CHK_DONE, 1);
+
+SIGNAL_LIST(CheckerInputs, CHK_EXPECTED, CHK_ACTUAL);
+SIGNAL_LIST(CheckerOutputs, CHK_ERR, CHK_DONE);
+
+class Checker: MODULE(CheckerInputs, CheckerOutputs) {
+  size_t const cycles;
+  size_t count = 0;
+  bool error = false;
+public:
+  EVENT_DRIVEN();
+
+  Checker(size_t n):
+    cycles(n)
+  {}
+
+  ON_CLOCK_RISING() {
+    bool const wrong = (GET_INPUT(CHK_EXPECTED) != GET_INPUT(CHK_ACTUAL));
+    ++count;
+    if ((wrong && !error) || count == cycles) {
+      STATE_CHANGED();
+    }
+    error = error || wrong;
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(CHK_ERR, error);
+    SET_OUTPUT(CHK_DONE, count >= cycles);
+  }
+
+  RESET() {
+    count = 0;
+    error = false;
+  }
+};
+
+// ------------ SYSTEM --------------
+class SplitterChain: public System {
+public:
+  SplitterChain(size_t cycles, size_t stages) {
+    auto &counter = addModule<Counter>();
+    auto &check = addModule<Checker>(cycles);
+
+    Joiner<64> *previous = nullptr;
+    for (size_t idx = 0; idx != stages; ++idx) {
+      auto &split = addModule<Splitter<64>>();
+      auto &join = addModule<Joiner<64>>();
+      if (previous) CONNECT_MOD(split, SPLITTER_IN, *previous, JOINER_OUT);
+      else CONNECT_MOD(split, SPLITTER_IN, counter, CNT_OUT);
+      connectBits(split, join, std::make_index_sequence<64>{});
+      previous = &join;
+    }
+
+    CONNECT_MOD(check, CHK_EXPECTED, counter, CNT_OUT);
+    CONNECT_MOD(check, CHK_ACTUAL, *previous, JOINER_OUT);
+    connectError<CHK_ERR>(check);
+    connectExit<CHK_DONE>(check);
+    init();
+  }
+
+private:
+  template <size_t I, typename ... Signals>
+  static auto nth(Impl::Signals_<Signals ...>) -> std::tuple_element_t<I, std::tuple<Signals ...>>;
+
+  template <size_t I, typename SignalList>
+  using Nth = decltype(nth<I>(std::declval<SignalList>()));
+  
+  template <size_t ... I>
+  static void connectBits(Splitter<64> &split, Joiner<64> &join, std::index_sequence<I ...>) {
+    (join.connect<Nth<I, Joiner<64>::Inputs>, Nth<I, Splitter<64>::Outputs>>(split), ...);
+  }
+};
+
+int main(int argc, char **argv) try {
+  size_t const cycles = (argc > 1) ? std::stoul(argv[1]) : 100'000;
+  size_t const stages = (argc > 2) ? std::stoul(argv[2]) : 16;
+
+  SplitterChain sys(cycles, stages);
+  sys.resetStatistics();
+
+  auto const start = std::chrono::steady_clock::now();
+  size_t count = 0;
+  while (sys.step()) {
+    ++count;
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  double const seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << "Modules:               " << sys.moduleNames().size() << '\n'
+	    << "Cycles:                " << count << '\n'
+	    << "Result:                " << (sys.getInput<SYS_ERR>() ? "WRONG VALUE" : "OK") << '\n'
+	    << "Cycles/sec:            " << (count / seconds) << '\n'
+	    << "Updates per half-step: " << (count ? double(sys.statistics().updates) / (2 * count) : 0.0) << '\n';
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <chrono>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../../rinku/rinku.h"
+
+// VCD export benchmark: a number of chains of inverters, each driven by a
+// source that toggles with a period of its own, are monitored by one scope
+// per chain (1000 signals in total by default). After running the system, the
+// VCD output is generated twice: once by System::vcd(), which merges the
+// histories of the signals, and once by collecting all value changes of all
+// scopes into one vector and sorting it by time, which is how vcd() used to
+// work. Both results must be identical.
+
+using namespace Rinku;
+
+// ------------ SOURCE --------------
+OUTPUT(SRC_OUT, 1);
+SIGNAL_LIST(SourceOutputs, SRC_OUT);
+
+class Source: MODULE(SourceOutputs) {
+  size_t const period;
+  size_t count = 0;
+  signal_t value = 0;
+public:
+  EVENT_DRIVEN();
+
+  Source(size_t p):
+    period(p)
+  {}
+
+  ON_CLOCK_RISING() {
+    if (++count == period) {
+      count = 0;
+      value ^= 1;
+      STATE_CHANGED();
+    }
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(SRC_OUT, value);
+  }
+
+  RESET() {
+    count = 0;
+    value = 0;
+  }
+};
+
+// ------------ INVERTER --------------
+INPUT(INV_IN, 1);
+OUTPUT(INV_OUT, 1);
+SIGNAL_LIST(InverterInputs, INV_IN);
+SIGNAL_LIST(InverterOutputs, INV_OUT);
+
+class Inverter: MODULE(InverterInputs, InverterOutputs) {
+public:
+  EVENT_DRIVEN();
+
+  UPDATE() {
+    SET_OUTPUT(INV_OUT, !GET_INPUT(INV_IN));
+  }
+};
+
+// ------------ SYSTEM --------------
+class Chains: public System {
+public:
+  Chains(size_t chains, size_t length) {
+    for (size_t chain = 0; chain != chains; ++chain) {
+      std::string const name = "chain" + std::to_string(chain);
+      auto &source = addModule<Source>(name + "_src", 1000 + 17 * chain);
+      VcdScope &scope = addScope(name);
+
+      Inverter *previous = nullptr;
+      for (size_t idx = 0; idx != length; ++idx) {
+	auto &inv = addModule<Inverter>(name + "_inv" + std::to_string(idx));
+	if (previous) inv.connect<INV_IN, INV_OUT>(*previous);
+	else inv.connect<INV_IN, SRC_OUT>(source);
+	scope.monitor(inv);
+	previous = &inv;
+      }
+    }
+    init();
+  }
+};
+
+// The way System::vcd() used to order the value changes
+std::string sortedVcd(System &sys, size_t chains, size_t &events) {
+  Impl::VcdEncoder out;
+  std::vector<VcdScope::VCD::Event> all;
+  for (size_t chain = 0; chain != chains; ++chain) {
+    VcdScope::VCD const vcd = sys.getScope("chain" + std::to_string(chain)).vcd();
+    out.write(vcd.definitions);
+    all.insert(all.end(), vcd.events.begin(), vcd.events.end());
+  }
+  std::stable_sort(all.begin(), all.end(), [](auto const &a, auto const &b) {
+    return a.time < b.time;
+  });
+
+  for (auto const &event: all) {
+    out.change(event.time, event.id, event.value, event.width);
+  }
+
+  events = all.size();
+  return out.take();
+}
+
+template <typename Function>
+double measure(Function &&fun) {
+  auto const start = std::chrono::steady_clock::now();
+  fun();
+  auto const stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char **argv) try {
+  size_t const cycles = (argc > 1) ? std::stoul(argv[1]) : 10'000'000;
+  size_t const chains = (argc > 2) ? std::stoul(argv[2]) : 10;
+  size_t const length = (argc > 3) ? std::stoul(argv[3]) : 100;
+
+  Chains sys(chains, length);
+  double const runTime = measure([&] {
+    for (size_t cycle = 0; cycle != cycles; ++cycle) sys.step();
+  });
+
+  std::string merged, sorted;
+  size_t events = 0;
+  double const mergeTime = measure([&] { merged = sys.vcd(); });
+  double const sortTime = measure([&] { sorted = sortedVcd(sys, chains, events); });
+
+  // Skip the header, which holds the current date
+  bool const same = merged.substr(merged.find("$scope")) == sorted;
+
+  std::cout << "Monitored signals:     " << (chains * length) << '\n'
+	    << "Clock cycles:          " << cycles << '\n'
+	    << "Value changes:         " << events << '\n'
+	    << "Simulation:            " << runTime << " s\n"
+	    << "VCD size:              " << (merged.size() >> 20) << " MB\n"
+	    << "Export (sort):         " << sortTime << " s, "
+	    << ((events * sizeof(VcdScope::VCD::Event)) >> 20) << " MB of intermediate events\n"
+	    << "Export (merge):        " << mergeTime << " s\n"
+	    << "Speedup:               " << (sortTime / mergeTime) << '\n'
+	    << "Result:                " << (same ? "SAME" : "DIFFERENT") << '\n';
+  return same ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
@@ -19,30 +19,31 @@ using namespace Rinku::Util; // for splitter, joiner and bus
 #include "program.h"
 #include "controlunit.h" 
 
-// Wire up the system
-BFComputer::BFComputer(std::string const &filename, double frequency):
-  System(frequency)
-{
-
-  auto& dataBus	   = System::addModule<Bus>("databus");
-  auto& addressBus = System::addModule<Bus>("addressbus");
-  auto& faReg	   = System::addModule<CountingRegister<4>>("fa");
-  auto& fbReg	   = System::addModule<CountingRegister<4>>("fb");
-  auto& ccReg	   = System::addModule<CountingRegister<4>>("cc");
-  auto& dReg	   = System::addModule<CountingRegister<8>>("d");
-  auto& iReg	   = System::addModule<CountingRegister<8>>("i");
-  auto& spReg	   = System::addModule<CountingRegister<8>>("sp");
-  auto& lsReg	   = System::addModule<CountingRegister<8>>("ls");
-  auto& dpReg	   = System::addModule<CountingRegister<16>>("dp", 0x0100);
-  auto& ipReg	   = System::addModule<CountingRegister<16>>("ip");
-  auto& rd	   = System::addModule<RegisterDriver>("rd");
-  auto& ram	   = System::addModule<RAM<8*1024>>("ram");
-  auto& cu	   = System::addModule<ControlUnit>("cu");
-  auto& prog	   = System::addModule<Program>("prog", filename);
-  auto& scr	   = System::addModule<Screen>("scr");
-  auto& faJoin	   = System::addModule<Joiner<4>>();
-  auto& fbJoin	   = System::addModule<Joiner<4>>();
-  auto& faSplit	   = System::addModule<Splitter<4>>(); 
+// Wire up the system. This is shared by the dynamic and the static version of
+// the computer, so the modules must be added in the order in which they are
+// listed in StaticBFComputer below.
+template <typename SystemT>
+void wire(SystemT &sys, std::string const &filename, std::ostream &screen) {
+
+  Bus&                  dataBus    = sys.template addModule<Bus>("databus");
+  Bus&                  addressBus = sys.template addModule<Bus>("addressbus");
+  CountingRegister<4>&  faReg      = sys.template addModule<CountingRegister<4>>("fa");
+  CountingRegister<4>&  fbReg      = sys.template addModule<CountingRegister<4>>("fb");
+  CountingRegister<4>&  ccReg      = sys.template addModule<CountingRegister<4>>("cc");
+  CountingRegister<8>&  dReg       = sys.template addModule<CountingRegister<8>>("d");
+  CountingRegister<8>&  iReg       = sys.template addModule<CountingRegister<8>>("i");
+  CountingRegister<8>&  spReg      = sys.template addModule<CountingRegister<8>>("sp");
+  CountingRegister<8>&  lsReg      = sys.template addModule<CountingRegister<8>>("ls");
+  CountingRegister<16>& dpReg      = sys.template addModule<CountingRegister<16>>("dp", 0x0100);
+  CountingRegister<16>& ipReg      = sys.template addModule<CountingRegister<16>>("ip");
+  RegisterDriver&       rd         = sys.template addModule<RegisterDriver>("rd");
+  RAM<8*1024>&          ram        = sys.template addModule<RAM<8*1024>>("ram");
+  ControlUnit&          cu         = sys.template addModule<ControlUnit>("cu");
+  Program&              prog       = sys.template addModule<Program>("prog", filename);
+  Screen&               scr        = sys.template addModule<Screen>("scr", screen);
+  Joiner<4>&            faJoin     = sys.template addModule<Joiner<4>>();
+  Joiner<4>&            fbJoin     = sys.template addModule<Joiner<4>>();
+  Splitter<4>&          faSplit    = sys.template addModule<Splitter<4>>(); 
 
   // Connect databus inputs
   CONNECT_MOD(dataBus, BUS_DATA_IN, ram, RAM_DATA_OUT);
@@ -151,13 +152,38 @@ BFComputer::BFComputer(std::string const &filename, double frequency):
   CONNECT_MOD(cu, CU_CC_IN, ccReg, CR_DATA_OUT);
   
   // Connect HLT, ERR and EXIT
-  connectHalt<CU_HLT>(cu);
-  connectError<CU_ERR>(cu);
-  connectExit<PROG_EXIT>(prog);
+  sys.template connectHalt<CU_HLT>(cu);
+  sys.template connectError<CU_ERR>(cu);
+  sys.template connectExit<PROG_EXIT>(prog);
 
   // Connect scope
-  addScope("CUScope").monitor(cu);
+  sys.addScope("CUScope").monitor(cu);
   
   // Done -> initialize system
-  init();
+  sys.init();
+}
+
+BFComputer::BFComputer(std::string const &filename, double frequency, std::ostream &screen):
+  System(frequency)
+{
+  wire(*this, filename, screen);
+}
+
+using StaticBFModules = StaticSystem<Bus, Bus,
+				     CountingRegister<4>, CountingRegister<4>, CountingRegister<4>,
+				     CountingRegister<8>, CountingRegister<8>, CountingRegister<8>, CountingRegister<8>,
+				     CountingRegister<16>, CountingRegister<16>,
+				     RegisterDriver, RAM<8*1024>, ControlUnit, Program, Screen,
+				     Joiner<4>, Joiner<4>, Splitter<4>>;
+
+struct StaticBFComputer: StaticBFModules {
+  StaticBFComputer(std::string const &filename, double frequency, std::ostream &screen):
+    StaticBFModules(frequency)
+  {
+    wire(*this, filename, screen);
+  }
+};
+
+std::unique_ptr<System> makeStaticBFComputer(std::string const &filename, double frequency, std::ostream &screen) {
+  return std::make_unique<StaticBFComputer>(filename, frequency, screen);
 }
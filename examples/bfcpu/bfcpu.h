@@ -6,8 +6,12 @@
 #include "../../rinku/rinku.h"
 
 struct BFComputer: Rinku::System {
-  BFComputer(std::string const &filename, double frequency = 1);
+  BFComputer(std::string const &filename, double frequency = 1, std::ostream &screen = std::cout);
 };
 
+// The same computer built as a StaticSystem: its module types are fixed at
+// compile time, so modules are updated and clocked without virtual calls.
+std::unique_ptr<Rinku::System> makeStaticBFComputer(std::string const &filename, double frequency = 1, std::ostream &screen = std::cout);
+
 
 #endif // BFCPU_H
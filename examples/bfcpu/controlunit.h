@@ -64,6 +64,8 @@ class ControlUnit: MODULE(ControlUnitInputs, ControlUnitOutputs)
   bool needsUpdate = true;
   
 public:
+  EVENT_DRIVEN();
+  
   ControlUnit():
     microcodeRom(loadImages())
   {}
@@ -81,6 +83,9 @@ public:
     signal_t newSignals = microcodeRom[address];
     needsUpdate = (newSignals != currentSignals);
     currentSignals = microcodeRom[address];
+    if (needsUpdate) {
+      STATE_CHANGED();
+    }
   }
 
   UPDATE() {
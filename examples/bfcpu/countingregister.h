@@ -32,6 +32,8 @@ class CountingRegister: MODULE(CountingRegisterInputs, CountingRegisterOutputs)
   bool needsUpdate = true;
   
 public:
+  EVENT_DRIVEN();
+  
   explicit CountingRegister(size_t val = 0):
     resetValue(val),
     value(val)
@@ -41,6 +43,7 @@ public:
     if (GET_INPUT(CR_LD)) {
       value = GET_INPUT(CR_DATA_IN);
       needsUpdate = true;
+      STATE_CHANGED();
       return;
     }
 
@@ -51,10 +54,12 @@ public:
     if (INC) {
       value = (value + 1) % MAX_VALUE;
       needsUpdate = true;
+      STATE_CHANGED();
     }
     else if (DEC) {
       value = (value - 1 + MAX_VALUE) % MAX_VALUE;
       needsUpdate = true;
+      STATE_CHANGED();
     }
   }
 
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include "bfcpu.h"
+
+// Count every heap allocation made by the process, so we can verify that
+// the settle loop does not allocate while the system is running.
+static size_t allocationCount = 0;
+
+void *operator new(size_t size) {
+  ++allocationCount;
+  if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+// Runs the given computer for a number of cycles (after a short warmup) and
+// reports its speed, the number of allocations and the settle statistics.
+void benchmark(std::string const &label, Rinku::System &cpu, size_t cycles) {
+  size_t const warmup = 1000;
+
+  // The screen output of the program is not part of the benchmark
+  std::ostringstream screen;
+  std::streambuf *coutBuf = std::cout.rdbuf(screen.rdbuf());
+
+  for (size_t idx = 0; idx != warmup; ++idx) {
+    cpu.step(true);
+  }
+
+  cpu.resetStatistics();
+  size_t const allocationsBefore = allocationCount;
+  auto const start = std::chrono::steady_clock::now();
+
+  size_t count = 0;
+  while (count != cycles && cpu.step(true)) {
+    ++count;
+  }
+  
+  auto const stop = std::chrono::steady_clock::now();
+  size_t const allocations = allocationCount - allocationsBefore;
+  std::cout.rdbuf(coutBuf);
+
+  double const seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << "[" << label << "]\n"
+	    << "Cycles:                " << count << '\n'
+	    << "Time:                  " << seconds << " s\n"
+	    << "Cycles/sec:            " << (count / seconds) << '\n'
+	    << "Allocations:           " << allocations << '\n'
+	    << "Allocations per cycle: " << (count ? double(allocations) / count : 0.0) << '\n';
+
+  auto const &stats = cpu.statistics();
+  std::cout << "Schedule levels:       " << stats.levels << '\n'
+	    << "Modules in loops:      " << stats.cyclicModules << '\n'
+	    << "Tabulated modules:     " << stats.tabulatedModules << '\n'
+	    << "Frozen modules:        " << stats.frozenModules << '\n'
+	    << "Aliased wires:         " << stats.aliasedWires << '\n'
+	    << "Updates per half-step: " << (count ? double(stats.updates) / (2 * count) : 0.0) << '\n';
+}
+
+int main(int argc, char **argv) try {
+  if (argc < 2) {
+    std::cerr << "Insufficient arguments: " << argv[0] << " <program.bin> [cycles] [dynamic|static|both]\n";
+    return 1;
+  }
+
+  size_t const cycles = (argc > 2) ? std::stoul(argv[2]) : 1'000'000;
+  std::string const mode = (argc > 3) ? argv[3] : "both";
+
+  // The computers are built with the screen output going to cout, which is
+  // redirected while the benchmark runs
+  if (mode == "dynamic" || mode == "both") {
+    BFComputer cpu(argv[1]);
+    benchmark("System", cpu, cycles);
+  }
+  if (mode == "static" || mode == "both") {
+    auto cpu = makeStaticBFComputer(argv[1]);
+    benchmark("StaticSystem", *cpu, cycles);
+  }
+  
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include "bfcpu.h"
+#include "../../rinku/rinku_ensemble.h"
+
+// Runs every program given on the command line a number of times as one
+// ensemble, first on a single thread and then on all available threads, and
+// checks that both produced the same results.
+
+// Each run writes to its own screen buffer instead of std::cout. The buffer is
+// a base class so that it is constructed before the computer that uses it.
+struct ScreenBuffer {
+  std::ostringstream screen;
+};
+
+struct BufferedBFComputer: ScreenBuffer, BFComputer {
+  BufferedBFComputer(std::string const &filename):
+    BFComputer(filename, 1e5, screen)
+  {}
+};
+
+// Strip the $date line, which depends on the time the trace was generated
+std::string withoutDate(std::string const &vcd) {
+  size_t const pos = vcd.find('\n');
+  return (pos == std::string::npos) ? vcd : vcd.substr(pos);
+}
+
+bool sameResult(Rinku::RunResult const &a, Rinku::RunResult const &b) {
+  return a.status == b.status && a.exitCode == b.exitCode && a.cycles == b.cycles
+    && a.error == b.error && withoutDate(a.vcd) == withoutDate(b.vcd);
+}
+
+char const *statusName(Rinku::RunStatus status) {
+  switch (status) {
+  case Rinku::RunStatus::Exit:       return "exit";
+  case Rinku::RunStatus::Error:      return "error";
+  case Rinku::RunStatus::CycleLimit: return "cycle limit";
+  case Rinku::RunStatus::Exception:  return "exception";
+  }
+  return "";
+}
+
+int main(int argc, char **argv) try {
+  if (argc < 2) {
+    std::cerr << "Insufficient arguments: " << argv[0] << " <program.bin> [<program.bin> ...] [copies] [max cycles] [threads]\n"
+	      << "  copies, max cycles and threads are recognized by being numeric.\n";
+    return 1;
+  }
+
+  std::vector<std::string> programs;
+  std::vector<size_t> numbers;
+  for (int idx = 1; idx != argc; ++idx) {
+    std::string const arg = argv[idx];
+    if (arg.find_first_not_of("0123456789") == std::string::npos) numbers.push_back(std::stoul(arg));
+    else programs.push_back(arg);
+  }
+
+  size_t const copies = (numbers.size() > 0) ? numbers[0] : 4;
+  size_t const maxCycles = (numbers.size() > 1) ? numbers[1] : 1'000'000;
+  size_t const threads = (numbers.size() > 2) ? numbers[2] : std::max(std::thread::hardware_concurrency(), 1u);
+
+  std::vector<std::string> configs;
+  for (size_t copy = 0; copy != copies; ++copy) {
+    configs.insert(configs.end(), programs.begin(), programs.end());
+  }
+
+  Rinku::Ensemble<std::string> ensemble([](std::string const &filename) {
+    return std::make_unique<BufferedBFComputer>(filename);
+  });
+  ensemble.maxCycles(maxCycles).recordVcd();
+
+  auto const time = [&](size_t n, std::vector<Rinku::RunResult> &results) {
+    auto const start = std::chrono::steady_clock::now();
+    results = Rinku::Ensemble<std::string>(ensemble).threads(n).run(configs);
+    auto const stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+  };
+
+  std::vector<Rinku::RunResult> serial, parallel;
+  double const serialTime = time(1, serial);
+  double const parallelTime = time(threads, parallel);
+
+  size_t mismatches = 0;
+  for (size_t idx = 0; idx != configs.size(); ++idx) {
+    if (!sameResult(serial[idx], parallel[idx])) {
+      std::cerr << "Run " << idx << " (" << configs[idx] << "): ensemble result differs from serial run.\n";
+      ++mismatches;
+    }
+  }
+
+  for (size_t idx = 0; idx != programs.size(); ++idx) {
+    Rinku::RunResult const &result = serial[idx];
+    std::cout << programs[idx] << ": " << statusName(result.status) << ", exit code "
+	      << result.exitCode << ", " << result.cycles << " cycles"
+	      << (result.error.empty() ? "" : " (" + result.error + ")") << '\n';
+  }
+
+  std::cout << configs.size() << " runs, 1 thread: " << serialTime << "s, "
+	    << threads << " threads: " << parallelTime << "s: "
+	    << (mismatches ? "FAILED" : "OK") << '\n';
+  return mismatches ? 1 : 0;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
@@ -4,17 +4,20 @@
 
 int main(int argc, char **argv) try {
   if (argc < 2) {
-    std::cerr << "Insufficient arguments: " << argv[0] << " <program.bin> [VCD file]\n";
+    std::cerr << "Insufficient arguments: " << argv[0] << " <program.bin> [VCD or .rwf file]\n";
     return 1;
   }
   
   BFComputer cpu(argv[1], 1e5);
-  Rinku::signal_t err = cpu.run(true);
 
+  // Write the waveforms while running, so long runs don't fill up memory
   if (argc > 2) {
-    std::ofstream vcdFile(argv[2]);
-    vcdFile << cpu.vcd() << '\n';
+    std::string const filename = argv[2];
+    if (filename.ends_with(".rwf")) cpu.streamWaveform(filename);
+    else cpu.streamVcd(filename);
   }
+  Rinku::signal_t err = cpu.run(true);
+
   std::cout << "DONE! Exit code: " << err << '\n';
   
  } catch (Rinku::Error::Exception &err) {
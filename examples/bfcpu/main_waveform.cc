@@ -0,0 +1,93 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <filesystem>
+#include "bfcpu.h"
+
+// Compares the VCD and waveform exports of the control unit scope. The program
+// is run once while recording the history in memory, which is exported both
+// ways, and then twice more while streaming to a VCD file and to a waveform
+// file. The waveform is converted back to VCD, which must be identical to the
+// VCD export.
+
+template <typename Function>
+double measure(Function &&fun) {
+  auto const start = std::chrono::steady_clock::now();
+  fun();
+  auto const stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+size_t run(BFComputer &cpu, size_t cycles) {
+  size_t count = 0;
+  while (count != cycles && cpu.step(true)) {
+    ++count;
+  }
+  return count;
+}
+
+int main(int argc, char **argv) try {
+  if (argc < 2) {
+    std::cerr << "Insufficient arguments: " << argv[0] << " <program.bin> [cycles]\n";
+    return 1;
+  }
+
+  size_t const cycles = (argc > 2) ? std::stoul(argv[2]) : 1'000'000;
+  std::filesystem::path const dir = std::filesystem::temp_directory_path();
+  std::string const vcdFile = (dir / "bfcpu_trace.vcd").string();
+  std::string const waveFile = (dir / "bfcpu_trace.rwf").string();
+  std::ostringstream screen;
+
+  // Export after running
+  std::string vcd, wave;
+  double vcdExport, waveExport;
+  size_t count;
+  {
+    BFComputer cpu(argv[1], 1e5, screen);
+    count = run(cpu, cycles);
+    vcdExport = measure([&] { vcd = cpu.vcd(); });
+    waveExport = measure([&] { wave = cpu.waveform(); });
+  }
+
+  // Streaming while running
+  double vcdStream, waveStream, plain;
+  {
+    BFComputer cpu(argv[1], 1e5, screen);
+    plain = measure([&] { run(cpu, cycles); });
+  }
+  vcdStream = measure([&] {
+    BFComputer cpu(argv[1], 1e5, screen);
+    cpu.streamVcd(vcdFile);
+    run(cpu, cycles);
+  });
+  waveStream = measure([&] {
+    BFComputer cpu(argv[1], 1e5, screen);
+    cpu.streamWaveform(waveFile);
+    run(cpu, cycles);
+  });
+
+  // Round trip, without the $date line
+  std::ostringstream converted;
+  Rinku::Waveform(waveFile).vcd(converted);
+  bool const same = (converted.str() == vcd.substr(vcd.find('\n') + 1));
+
+  size_t const vcdSize = std::filesystem::file_size(vcdFile);
+  size_t const waveSize = std::filesystem::file_size(waveFile);
+  std::filesystem::remove(vcdFile);
+  std::filesystem::remove(waveFile);
+
+  std::cout << "Cycles:                " << count << '\n'
+	    << "VCD export:            " << (vcd.size() >> 10) << " kB in " << vcdExport << " s\n"
+	    << "Waveform export:       " << (wave.size() >> 10) << " kB in " << waveExport << " s\n"
+	    << "Size ratio:            " << (double(vcd.size()) / wave.size()) << '\n'
+	    << "Run recording history: " << plain << " s\n"
+	    << "Run streaming VCD:     " << vcdStream << " s, " << (vcdSize >> 10) << " kB\n"
+	    << "Run streaming wave:    " << waveStream << " s, " << (waveSize >> 10) << " kB\n"
+	    << "Round trip:            " << (same ? "SAME" : "DIFFERENT") << '\n';
+  return same ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
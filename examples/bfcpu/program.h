@@ -15,6 +15,8 @@ class Program: MODULE(ProgramInputSignals, ProgramOutputSignals) {
   std::vector<unsigned char> data;
   
 public:
+  EVENT_DRIVEN();
+  
   Program(std::string const &filename){
     std::ifstream file(filename);
     assert(file && "Could not open file");
@@ -21,9 +21,12 @@ class RAM: MODULE(RamInputs, RamOutputs) {
   size_t address;
 
 public:
+  EVENT_DRIVEN();
+  
   ON_CLOCK_FALLING() {
     if (GET_INPUT(WE_RAM)) {
       data[address] = GET_INPUT(RAM_DATA_IN);
+      STATE_CHANGED();
     }
   }
 
@@ -38,9 +38,14 @@ SIGNAL_LIST(RegisterDriverOutputs,
 class RegisterDriver: MODULE(RegisterDriverInputs, RegisterDriverOutputs) {
 
 public:
-  UPDATE() {
+  // The outputs only depend on the 5 input bits. Building a lookup table would
+  // evaluate the combination where INC and DEC are both active, which the
+  // microcode never produces and the update asserts against.
+  NO_LOOKUP_TABLE();
+  
+  PURE_UPDATE() {
     bool inc = GET_INPUT(RD_INC);
-    bool dec = GET_INPUT(RD_DEC);;
+    bool dec = GET_INPUT(RD_DEC);
     assert(!(inc && dec) && "INC/DEC active at the same time");
 
     size_t registerIndex = 0;
@@ -7,10 +7,19 @@ SIGNAL_LIST(ScreenInputs,
 	    SCR_DATA_IN);
 	    
 class Screen: MODULE(ScreenInputs) {
+  std::ostream &out;
+  
 public:
+  EVENT_DRIVEN();
+  SERIAL_CLOCK(); // writes to a stream that may be shared with other systems
+  
+  Screen(std::ostream &os = std::cout):
+    out(os)
+  {}
+  
   ON_CLOCK_FALLING() {
     if (GET_INPUT(SCR_EN)) {
-      std::cout << (char)GET_INPUT(SCR_DATA_IN);
+      out << (char)GET_INPUT(SCR_DATA_IN);
     }
   }
 };
@@ -0,0 +1,34 @@
+#include <iostream>
+#include <fstream>
+
+#include "../../rinku/rinku.h"
+
+// Converts a file in the Rinku waveform format (written by System::waveform()
+// or System::streamWaveform()) to VCD, so it can be opened in a VCD viewer like
+// GTKWave. The blocks of the waveform are converted one at a time. Optionally,
+// only the changes within a range of times are converted.
+
+int main(int argc, char **argv) try {
+  if (argc < 3) {
+    std::cerr << "Insufficient arguments: " << argv[0] << " <input.rwf> <output.vcd> [from] [to]\n";
+    return 1;
+  }
+
+  Rinku::Waveform const waveform(argv[1]);
+  size_t const from = (argc > 3) ? std::stoul(argv[3]) : 0;
+  size_t const to = (argc > 4) ? std::stoul(argv[4]) : -1;
+  
+  std::ofstream out(argv[2], std::ios::binary);
+  if (!out) {
+    std::cerr << "Could not open \"" << argv[2] << "\" for writing.\n";
+    return 1;
+  }
+  waveform.vcd(out, from, to);
+
+  std::cerr << waveform.signals().size() << " signals, times "
+	    << waveform.firstTime() << " to " << waveform.lastTime() << '\n';
+  
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
@@ -3,7 +3,7 @@
 
 #include "../rinku.h"
 
-#define RINKU_BINARY_GATE(NAME, PREFIX, RESULT)				\
+#define RINKU_BINARY_GATE(NAME, PREFIX, KIND, RESULT)			\
   RINKU_INPUT(PREFIX##_IN_A, 1);					\
   RINKU_INPUT(PREFIX##_IN_B, 1);					\
   RINKU_OUTPUT(PREFIX##_OUT, 1);					\
@@ -12,6 +12,12 @@
 									\
   struct NAME : RINKU_MODULE(NAME##Inputs, NAME##Outputs) {		\
   public:								\
+    RINKU_EVENT_DRIVEN();						\
+									\
+    virtual Rinku::Impl::GateKind gateKind() const override {		\
+      return Rinku::Impl::GateKind::KIND;				\
+    }									\
+									\
     RINKU_UPDATE() {							\
       bool a = getInput<PREFIX##_IN_A>();				\
       bool b = getInput<PREFIX##_IN_B>();				\
@@ -19,17 +25,84 @@
     }									\
   };
 
+// Same gates, but every bit of a signal is an independent lane
+#define RINKU_LANE_GATE(NAME, PREFIX, KIND, RESULT)			\
+  RINKU_INPUT(PREFIX##_IN_A, Rinku::Logic::Lanes::N);			\
+  RINKU_INPUT(PREFIX##_IN_B, Rinku::Logic::Lanes::N);			\
+  RINKU_OUTPUT(PREFIX##_OUT, Rinku::Logic::Lanes::N);			\
+  RINKU_SIGNAL_LIST(NAME##Inputs, PREFIX##_IN_A, PREFIX##_IN_B);	\
+  RINKU_SIGNAL_LIST(NAME##Outputs, PREFIX##_OUT);			\
+									\
+  struct NAME : RINKU_MODULE(NAME##Inputs, NAME##Outputs) {		\
+  public:								\
+    RINKU_EVENT_DRIVEN();						\
+									\
+    virtual Rinku::Impl::GateKind gateKind() const override {		\
+      return Rinku::Impl::GateKind::KIND;				\
+    }									\
+									\
+    RINKU_UPDATE() {							\
+      signal_t a = getInput<PREFIX##_IN_A>();				\
+      signal_t b = getInput<PREFIX##_IN_B>();				\
+      setOutput<PREFIX##_OUT>(RESULT);					\
+    }									\
+  };
+
 namespace Rinku {
   namespace Logic {
     
     // Logic gates
-    RINKU_BINARY_GATE(And, AND, a&&b);
-    RINKU_BINARY_GATE(Or, OR, a||b);
-    RINKU_BINARY_GATE(Xor, XOR, a^b);
-    RINKU_BINARY_GATE(Nand, NAND, !(a&&b));
-    RINKU_BINARY_GATE(Nor, NOR, !(a||b));
-    RINKU_BINARY_GATE(Xnor, XNOR, !(a^b));
+    RINKU_BINARY_GATE(And, AND, And, a&&b);
+    RINKU_BINARY_GATE(Or, OR, Or, a||b);
+    RINKU_BINARY_GATE(Xor, XOR, Xor, a^b);
+    RINKU_BINARY_GATE(Nand, NAND, Nand, !(a&&b));
+    RINKU_BINARY_GATE(Nor, NOR, Nor, !(a||b));
+    RINKU_BINARY_GATE(Xnor, XNOR, Xnor, !(a^b));
+
+    // Bit-parallel logic gates. A 1-bit signal is carried in all 64 bits of a
+    // signal_t, each bit (lane) holding the value for a different test vector,
+    // so a single update evaluates the gate for 64 vectors at once. Apart from
+    // their width, the signals have the same names as those of the scalar
+    // gates above, and circuits are built from them in the same way.
+    namespace Lanes {
+
+      static constexpr size_t N = 8 * sizeof(signal_t);
+
+      RINKU_LANE_GATE(And, AND, And, a&b);
+      RINKU_LANE_GATE(Or, OR, Or, a|b);
+      RINKU_LANE_GATE(Xor, XOR, Xor, a^b);
+      RINKU_LANE_GATE(Nand, NAND, Nand, ~(a&b));
+      RINKU_LANE_GATE(Nor, NOR, Nor, ~(a|b));
+      RINKU_LANE_GATE(Xnor, XNOR, Xnor, ~(a^b));
+
+      // Exhaustive testing of a block with nInputs 1-bit inputs takes
+      // batches(nInputs) settles. In batch b, lane l of the value returned by
+      // exhaustive(i, b) is bit i of the input combination b * N + l, so all
+      // combinations are covered exactly once (for fewer than 6 inputs, the
+      // combinations repeat across the 64 lanes).
+      constexpr size_t batches(size_t nInputs) {
+	return (nInputs <= 6) ? 1 : (size_t(1) << (nInputs - 6));
+      }
+
+      constexpr signal_t exhaustive(size_t input, size_t batch) {
+	constexpr signal_t patterns[] = {
+	  0xaaaaaaaaaaaaaaaa,
+	  0xcccccccccccccccc,
+	  0xf0f0f0f0f0f0f0f0,
+	  0xff00ff00ff00ff00,
+	  0xffff0000ffff0000,
+	  0xffffffff00000000
+	};
+	if (input < 6) return patterns[input];
+	return ((batch >> (input - 6)) & 1) ? ~signal_t(0) : 0;
+      }
+
+      // Value of lane l of a signal
+      constexpr bool lane(signal_t value, size_t l) {
+	return (value >> l) & 1;
+      }
 
+    } // namespace Lanes
   } // namespace Logic
 } // namespace Rinku
 
@@ -8,6 +8,10 @@
 #include <numeric>
 #include <memory>
 #include <iostream>
+#include <fstream>
+#include <string_view>
+#include <charconv>
+#include <cstring>
 #include <iomanip>
 #include <bitset>
 #include <format>
@@ -16,6 +20,18 @@
 #include <set>
 #include <unordered_map>
 #include <cmath>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <queue>
+#include <span>
+#include <optional>
+#include <tuple>
+#include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 namespace Rinku {
   using signal_t = uint64_t;
@@ -43,7 +59,13 @@ namespace Rinku {
     struct SystemNotInitialized;
     struct InvalidScopeName;
     struct DuplicateScopeNames;
+    struct VcdFileError;
+    struct WaveformFileError;
+    struct InvalidWaveform;
     struct SystemFrequencyOutOfRange;
+    struct StaticModuleMismatch;
+    struct StaticSystemIncomplete;
+    struct PartitionAfterInit;
     
 #include "rinku_error.inl"
   }
@@ -64,15 +86,169 @@ namespace Rinku {
     
 #include "rinku_signals.inl" 
 
+    class Worklist {
+      std::vector<int> _schedule;
+      std::vector<size_t> _rank;
+      std::vector<uint64_t> _pending;
+      size_t _cursor = 0;
+      std::vector<int> _guaranteed;
+      bool _shared = false;
+
+    public:
+      void resize(std::vector<int> const &schedule);
+      void push(int idx);
+      void notify(int idx);
+      void share(bool value);
+      void pushAll();
+      std::vector<int> const &schedule() const;
+      void guarantee(int idx);
+      size_t lowestPending();
+      void take(size_t begin, size_t end, std::vector<int> &modules);
+      void erase(int idx);
+      void merge(Worklist &other);
+
+      template <typename Visitor>
+      void releaseGuarantees(Visitor &&visit);
+
+      template <typename Visitor>
+      void drain(Visitor &&visit);
+    }; // class Worklist
+
+#include "rinku_worklist.inl"
+
+    // A fixed set of threads that repeatedly run the same task together with
+    // the calling thread, which acts as worker 0.
+    class ThreadPool {
+      std::vector<std::thread> _threads;
+      std::mutex _mutex;
+      std::condition_variable _wake;
+      std::condition_variable _done;
+      void (*_call)(void *, size_t) = nullptr;
+      void *_task = nullptr;
+      size_t _generation = 0;
+      size_t _busy = 0;
+      bool _stop = false;
+      std::exception_ptr _error;
+
+    public:
+      ThreadPool(size_t nWorkers);
+      ~ThreadPool();
+      ThreadPool(ThreadPool const &) = delete;
+      ThreadPool &operator=(ThreadPool const &) = delete;
+
+      size_t size() const;
+
+      template <typename Task>
+      void run(Task &task);
+
+    private:
+      void work(size_t worker);
+    }; // class ThreadPool
+
+#include "rinku_threadpool.inl"
+
+    struct Driver {
+      signal_t const *ptr;
+      bool activeLow;
+      bool constant = false;
+
+      // Bits of the driving signal that reach the input when it is read
+      // through wire modules (see System::aliasWires()):
+      // ((value >> shift) & mask) << offset
+      uint8_t shift = 0;
+      uint8_t offset = 0;
+      signal_t mask = ~signal_t(0);
+
+      signal_t value() const;
+      signal_t select(signal_t value) const;
+      bool narrow(size_t shift, size_t offset, signal_t mask);
+      bool direct() const;
+    };
+
+    // How an input is read after System::init(). Constant drivers are folded
+    // into a single value, so that inputs with at most one driver that can
+    // change are read without looping over the netlist.
+    struct InputPath {
+      enum Kind: uint8_t {
+	Constant,
+	Single,
+	SingleInverted,
+	Multi
+      };
+
+      signal_t const *ptr = nullptr;
+      signal_t constant = 0;
+      Kind kind = Multi;
+    };
+
+    // Function of a two-input logic gate that can be fused into a logic block
+    // (see System::fuseLogic())
+    enum class GateKind: uint8_t {
+      None,
+      And,
+      Or,
+      Xor,
+      Nand,
+      Nor,
+      Xnor
+    };
+
+    // One gate of a fused logic block. The ops of a block are stored in
+    // schedule order; end points one past the last op of the block.
+    struct LogicOp {
+      InputPath a;
+      InputPath b;
+      signal_t *out = nullptr;
+      signal_t mask = 0;
+      GateKind kind = GateKind::None;
+      int module = -1;
+      uint32_t end = 0;
+      uint32_t fanoutBegin = 0;  // modules outside the block reading the output
+      uint32_t fanoutEnd = 0;
+      bool watched = false;      // the output is monitored by a scope
+    };
+    
+    class Netlist {
+      std::vector<Driver> _drivers;
+      std::vector<size_t> _driverOffsets {0};
+      std::vector<int> _fanout;
+      std::vector<size_t> _fanoutOffsets {0};
+      std::vector<signal_t> _constants;
+
+    public:
+      size_t addInput(std::vector<Driver> const &drivers, signal_t constant = 0);
+      size_t addOutput(std::vector<int> const &fanout);
+      void relocate(std::unordered_map<signal_t const*, signal_t const*> const &moved);
+      void clear();
+      std::span<Driver> inputRow(size_t slot);
+      std::span<int const> fanoutRow(size_t slot) const;
+      
+      Driver const *drivers() const;
+      size_t const *driverOffsets() const;
+      int const *fanout() const;
+      size_t const *fanoutOffsets() const;
+      signal_t const *constants() const;
+    }; // class Netlist
+
+#include "rinku_netlist.inl"
+
     class ModuleBase {
       friend class Debugger;
-      inline static size_t _count = 0;
+      inline static std::atomic<size_t> _count = 0;
       
       bool _locked = false;
       bool _setOutputAllowed = true;
       bool _guaranteed = false;
       bool _updateEnabled = true;
+      bool _eventDriven = false;
+      bool _pureUpdate = false;
+      bool _tableAllowed = true;
+      bool _frozen = false;
+      bool _aliased = false;
+      bool _updating = false;  // inside updateAs(), see outsideWrite()
       size_t _index = -1;
+      Worklist *_worklist = nullptr;
+      std::vector<int> *_reconfigured = nullptr;  // see System::reconfigure()
       std::string _name;
 
       std::vector<std::string> _dotConnections;
@@ -94,12 +270,26 @@ namespace Rinku {
 	}
       };
       
+      // One term of an output of a wire module (see wiring()): the output is the
+      // bitwise OR of ((input >> shift) & mask) << offset over all its terms.
+      struct WireTerm {
+	size_t input;
+	uint8_t shift = 0;
+	uint8_t offset = 0;
+	signal_t mask = ~signal_t(0);
+      };
+      
       virtual ~ModuleBase() = default;
       virtual void clockRising() {}
       virtual void clockFalling() {}
       virtual void update(GuaranteeToken) {}
       virtual void reset() {}
-      virtual std::vector<int> updateAndCheck() = 0;
+      virtual bool wiring(size_t, std::vector<WireTerm> &) const { return false; }
+      virtual void updateAndCheck(Worklist &worklist) = 0;
+      virtual std::vector<int> outgoingModules() const = 0;
+      virtual void addToNetlist(Netlist &netlist) = 0;
+      virtual void bindNetlist(Netlist const &netlist) = 0;
+      virtual void moveOutputs(signal_t *storage, std::unordered_map<signal_t const*, signal_t const*> &moved) = 0;
       virtual size_t nInputs() const = 0;
       virtual size_t nOutputs() const = 0;
       virtual size_t usedInputs() const;
@@ -112,13 +302,41 @@ namespace Rinku {
       virtual void setOutput(size_t, signal_t) = 0;
       virtual std::vector<std::string> getInputSignalNames() const = 0;
       virtual std::vector<std::string> getOutputSignalNames() const = 0;
+      virtual GateKind gateKind() const { return GateKind::None; }
+      virtual bool logicOp(LogicOp &op) const = 0;
+      virtual bool tabulate(size_t maxInputBits) = 0;
+      virtual void forgetInputs() = 0;
+      virtual bool wireTerms(size_t output, std::vector<WireTerm> &terms) const = 0;
+      virtual void watchOutput(signal_t const *ptr, std::vector<signal_t const *> *changes) = 0;
+      virtual void unwatchOutputs() = 0;
+      virtual void refreshWire() = 0;
       
       void update();
+
+      template <typename ModuleT>
+      void updateAs(Worklist *worklist);
+      
       void setModuleIndex(int idx);
       int getModuleIndex() const;
       void setName(std::string const &name);
       std::string const &name() const;
       void enableUpdate(bool val);      
+      void setEventDriven(bool val);
+      bool eventDriven() const;
+      void setPureUpdate(bool val);
+      bool pureUpdate() const;
+      void allowTable(bool val);
+      bool tableAllowed() const;
+      void freeze();
+      void unfreeze();
+      bool frozen() const;
+      void alias(std::vector<std::vector<WireTerm>> terms);
+      void unalias();
+      bool aliased() const;
+      std::vector<WireTerm> const &aliasTerms(size_t output) const;
+      void setWorklist(Worklist *worklist);
+      void setReconfigurationLog(std::vector<int> *log);
+      void stateChanged();
       void lock();
       bool locked() const;
       void allowSetOutput(bool value);
@@ -126,14 +344,31 @@ namespace Rinku {
       void resetGuaranteed();
       bool guaranteed() const;
       bool updateEnabled() const;
+      bool updating() const;
+      void outsideWrite();
 
       void addDotConnection(std::string const &str);
       void addHardwiredValue(signal_t value);
       std::vector<std::string> const &getDotConnections() const;
       std::set<signal_t> const &getHardwiredValues() const;
+
+    private:
+      std::vector<std::vector<WireTerm>> _aliasTerms;  // terms of each output while aliased
       
     }; // class ModuleBase
 
+    // Whether a module type leaves a clock handler of ModuleBase untouched. A
+    // handler that is not accessible is assumed to be overridden.
+    template <typename ModuleT>
+    constexpr bool inheritsClockRising = requires {
+      requires std::is_same_v<decltype(&ModuleT::clockRising), void (ModuleBase::*)()>;
+    };
+
+    template <typename ModuleT>
+    constexpr bool inheritsClockFalling = requires {
+      requires std::is_same_v<decltype(&ModuleT::clockFalling), void (ModuleBase::*)()>;
+    };
+
     
 #include "rinku_modulebase.inl"
   } // namespace Impl
@@ -153,6 +388,9 @@ namespace Rinku {
     
     friend class System;
     friend class Debugger;
+
+    template <typename ...>
+    friend class StaticSystem;
     
   public:
     using Inputs = std::conditional_t<
@@ -182,11 +420,37 @@ namespace Rinku {
     static constexpr size_t index_of = SignalList::template index_of<S>();
 
   private:
+    static constexpr size_t ChangedWords = (Outputs::N + 63) / 64;
+
+    // Members used on every update are kept together, so that updating a
+    // module touches as few cache lines as possible.
+    signal_t *outputs = outputState;  // moved into the system's signal arena by System::init()
+    uint64_t changedOutputs[std::max<size_t>(ChangedWords, 1)] {};  // bit set when an output took a new value
+    uint64_t watchedOutputs[std::max<size_t>(ChangedWords, 1)] {};  // bit set when a scope monitors the output
+    std::vector<signal_t const *> *changeLog = nullptr;  // receives the watched outputs that changed
+    signal_t const *table = nullptr;  // outputs for every input combination, see tabulate()
+    signal_t lastInputs[Inputs::N] {};  // inputs seen by the last update of a pure module
+    bool inputsKnown = false;           // lastInputs is valid
+
+    // View on the system's netlist, set by System::init(). The offsets of
+    // this module's rows are copied into the module itself, relative to its
+    // first driver and fanout entry, to save an indirection on every access.
+    Impl::Driver const *drivers = nullptr;
+    int const *fanout = nullptr;
+    uint32_t driverOffsets[Inputs::N + 1] {};
+    uint32_t fanoutOffsets[Outputs::N + 1] {};
+    Impl::InputPath inputPaths[Inputs::N] {};
+
+    // Outputs and connections as they are before System::init()
     signal_t outputState[Outputs::N] {};
     std::vector<int> outputModules[Outputs::N] {};
-    std::vector<std::pair<signal_t const*, bool>> inputState[Inputs::N];
+    std::vector<Impl::Driver> inputState[Inputs::N];
+    size_t inputSlot = 0;
+    size_t outputSlot = 0;
+    
     std::unordered_map<std::string, size_t> nameToInput;
     std::unordered_map<std::string, size_t> nameToOutput;
+    std::vector<signal_t> tableStorage;
     
   public:
     Module();
@@ -216,10 +480,33 @@ namespace Rinku {
     virtual signal_t getOutput(size_t outputIndex) const override final;
 
   private:
-    virtual std::vector<int> updateAndCheck() override final;
+    virtual void updateAndCheck(Impl::Worklist &worklist) override final;
+
+    template <typename ModuleT>
+    void updateAndCheckAs(Impl::Worklist &worklist);
+    virtual std::vector<int> outgoingModules() const override final;
+    virtual bool logicOp(Impl::LogicOp &op) const override final;
+    virtual bool tabulate(size_t maxInputBits) override final;
+    virtual void forgetInputs() override final;
+    virtual bool wireTerms(size_t output, std::vector<WireTerm> &terms) const override final;
+    virtual void watchOutput(signal_t const *ptr, std::vector<signal_t const *> *changes) override final;
+    virtual void unwatchOutputs() override final;
+    virtual void refreshWire() override final;
+    signal_t wireOutput(size_t outputIndex) const;
+    bool inputsChanged();
+    void lookup();
+    virtual void addToNetlist(Impl::Netlist &netlist) override final;
+    virtual void bindNetlist(Impl::Netlist const &netlist) override final;
+    virtual void moveOutputs(signal_t *storage, std::unordered_map<signal_t const*, signal_t const*> &moved) override final;
     
     void addOutgoing(size_t outputIndex, int idx);
-    std::vector<int> const &outgoing(size_t outputIndex);
+    std::span<int const> outgoing(size_t outputIndex) const;
+    std::span<Impl::Driver const> incoming(size_t inputIndex) const;
+    
+    // Unchecked access, used when the index is known to be valid
+    signal_t readInput(size_t inputIndex) const;
+    void writeOutput(size_t outputIndex, signal_t value);
+    signal_t readMultiInput(size_t inputIndex) const;
     bool connected(size_t inputIndex, signal_t const *ptr);
 
     template <typename InputSignal, typename OutputSignal, typename OtherModule>
@@ -233,13 +520,170 @@ namespace Rinku {
 
   class System;
 
+  namespace Impl {
+
+    // Encodes VCD value changes into a buffer of characters that grows as
+    // needed: 1-bit signals in scalar notation (1!), wider signals in binary
+    // without leading zeros (b101 !), preceded by a timestamp whenever the
+    // time moves on
+    class VcdEncoder {
+      std::string _buffer;
+      size_t _size = 0;
+      size_t _time = -1;
+
+      char *grow(size_t n);
+
+    public:
+      static std::string code(size_t index);
+
+      void reserve(size_t n);
+      void write(std::string const &text);
+      void change(size_t time, std::string const &code, signal_t value, size_t width);
+      size_t size() const;
+      std::string_view view() const;
+      std::string take();
+      void clear();
+    };
+
+    // Receives the value changes of all scopes while the system runs, see
+    // System::streamVcd() and System::streamWaveform(). Signals are numbered
+    // in the order in which they were added to the scopes.
+    class TraceStream {
+    public:
+      virtual ~TraceStream() = default;
+      virtual void change(size_t time, size_t signal, signal_t value) = 0;
+    };
+
+    // Writes value changes to a VCD file as they happen, through a buffer that
+    // is flushed to the file whenever it fills up
+    class VcdStream: public TraceStream {
+      std::ofstream _file;
+      VcdEncoder _encoder;
+      size_t _capacity;
+      std::vector<std::string> _codes;
+      std::vector<size_t> _widths;
+
+    public:
+      VcdStream(std::string const &filename, size_t bufferSize,
+		std::vector<std::string> const &codes, std::vector<size_t> const &widths);
+      ~VcdStream();
+
+      void write(std::string const &text);
+      virtual void change(size_t time, size_t signal, signal_t value) override;
+      void flush();
+    };
+  }
+
+  // Reads files in the Rinku waveform format, as written by System::waveform()
+  // and System::streamWaveform(). The format is described in the readme.
+  class Waveform {
+  public:
+    struct Signal {
+      std::string scope;
+      std::string name;
+      size_t width;
+    };
+
+    struct Change {
+      size_t time;
+      size_t signal;   // index into signals()
+      signal_t value;
+    };
+
+  private:
+    struct Block {
+      size_t offset;
+      size_t first;
+      size_t last;
+      size_t rawSize;
+      size_t storedSize;
+      size_t payload;
+    };
+    
+    std::string _filename;
+    mutable std::ifstream _file;
+    size_t _fileSize = 0;
+    std::string _timescale;
+    std::vector<Signal> _signals;
+    std::vector<Block> _blocks;
+
+  public:
+    Waveform(std::string const &filename);
+
+    std::string const &timescale() const;
+    std::vector<Signal> const &signals() const;
+    size_t firstTime() const;
+    size_t lastTime() const;
+
+    template <typename Callback>
+    void read(Callback &&callback, size_t from = 0, size_t to = -1) const;
+
+    void vcd(std::ostream &out, size_t from = 0, size_t to = -1) const;
+
+  private:
+    bool readIndex();
+    void scanBlocks(size_t offset);
+    bool readBlockHeader(size_t offset, Block &block) const;
+    std::string readBlock(Block const &block) const;
+    std::string readBytes(size_t offset, size_t count) const;
+    [[noreturn]] void invalid(std::string const &reason) const;
+  };
+
+  namespace Impl {
+
+    // Writes the Rinku waveform format: the signal definitions up front,
+    // followed by blocks of value changes that are compressed independently
+    // once they reach the block size, and an index of the blocks at the end
+    class WaveWriter {
+      std::ostream &_out;
+      std::vector<size_t> _widths;
+      size_t _blockSize;
+      size_t _offset = 0;
+      std::string _block;
+      size_t _first = 0;
+      size_t _time = 0;
+      size_t _next = 0;
+      size_t _changes = 0;
+      std::vector<std::array<size_t, 3>> _index;  // offset, first and last time
+      bool _finished = false;
+
+      void write(std::string const &bytes);
+      void flushBlock();
+
+    public:
+      WaveWriter(std::ostream &out, std::string const &timescale,
+		 std::vector<Waveform::Signal> const &signals, size_t blockSize);
+
+      void change(size_t time, size_t signal, signal_t value);
+      void finish();
+    };
+
+    class WaveStream: public TraceStream {
+      std::ofstream _file;
+      WaveWriter _writer;
+
+    public:
+      WaveStream(std::string const &filename, std::string const &timescale,
+		 std::vector<Waveform::Signal> const &signals, size_t blockSize);
+      ~WaveStream();
+
+      virtual void change(size_t time, size_t signal, signal_t value) override;
+    };
+  }
+
   class VcdScope {
+    friend class System;
     
     struct SignalLog {
       std::string mod;
       std::string name;
       signal_t const *ptr;
       signal_t mask;
+      std::string id;   // identifier code, see assignCodes()
+      size_t index;     // position among the signals of all scopes
+      size_t width;
+      signal_t last = 0;
+      bool sampled = false;
       std::vector<std::pair<size_t, signal_t>> history;
     };
 
@@ -271,13 +715,19 @@ namespace Rinku {
     template <typename OutputSignal1, typename OutputSignal2, typename ... OutputSignalRest, typename ModuleType>
     void monitor(ModuleType const &mod);    // Monitor multiple outputs
 
-    void sample(size_t time);
+    void sample(size_t time, Impl::TraceStream *stream = nullptr);
     VCD vcd() const;
     std::string const &name() const;
     
   private:
+    std::string definitions() const;
+    static std::string reference(SignalLog const &log);
+    static void sampleSignal(SignalLog &log, size_t time, Impl::TraceStream *stream);
+    size_t assignCodes(size_t first);
+    void restartSampling();
     void monitor(signal_t const *ptr, signal_t mask, std::string const &modName, std::string const &sigName);
     void monitorClock();
+    void relocate(std::unordered_map<signal_t const*, signal_t const*> const &moved);
 
   }; // class VcdScope
   
@@ -292,27 +742,136 @@ namespace Rinku {
     friend class VcdScope;
     
     class Clock_ {
-      std::vector<std::shared_ptr<Impl::ModuleBase>> _attached;
+      // Modules are only attached to the edges for which they override the
+      // handler. For parallel dispatch, the handlers of modules that declared
+      // SERIAL_CLOCK() are kept apart as well.
+      std::vector<Impl::ModuleBase*> _rising;
+      std::vector<Impl::ModuleBase*> _falling;
+      std::vector<Impl::ModuleBase*> _risingShared;
+      std::vector<Impl::ModuleBase*> _risingSerial;
+      std::vector<Impl::ModuleBase*> _fallingShared;
+      std::vector<Impl::ModuleBase*> _fallingSerial;
       signal_t _value = 0;
+
+      // Set by System::enableParallelClock()
+      Impl::ThreadPool *_pool = nullptr;
+      Impl::Worklist *_worklist = nullptr;
+      size_t _workers = 1;
+      size_t _minShared = 0;
       
     public:
       void rise();
       void fall();
+      void set(signal_t value);
       signal_t const &value() const;
+      bool parallel() const;
+      std::vector<bool> handlers(size_t nModules) const;
+      void dispatchOn(Impl::ThreadPool *pool, size_t workers, Impl::Worklist *worklist, size_t minHandlers);
 
       template <typename ModuleT>
       void attach(std::shared_ptr<ModuleT> const &m);
+
+    private:
+      void dispatch(std::vector<Impl::ModuleBase*> const &all,
+		    std::vector<Impl::ModuleBase*> const &shared,
+		    std::vector<Impl::ModuleBase*> const &serial,
+		    void (Impl::ModuleBase::*handler)());
+    };
+
+  public:
+    struct Statistics {
+      size_t settles = 0;        // number of calls to updateAll()
+      size_t updates = 0;        // number of module updates issued while settling
+      size_t levels = 0;         // depth of the evaluation schedule
+      size_t cyclicModules = 0;  // modules that are part of a combinational loop
+      size_t parallelLevels = 0; // levels that were evaluated on more than one thread
+      size_t rounds = 0;         // rounds of concurrent cluster evaluation (see partition())
+      size_t logicBlocks = 0;    // number of fused logic blocks (see fuseLogic())
+      size_t fusedGates = 0;     // gates evaluated as part of a logic block
+      size_t tabulatedModules = 0; // pure modules updated by table lookup
+      size_t frozenModules = 0;    // pure modules with constant outputs, see init()
+      size_t aliasedWires = 0;     // wire modules whose readers read their drivers, see init()
+      size_t samples = 0;          // monitored signals inspected by the scopes
+    };
+
+    struct Partition {
+      std::vector<size_t> sizes;   // number of modules in each cluster
+      size_t connections = 0;      // connections between modules
+      size_t cutConnections = 0;   // connections between modules in different clusters
+      size_t boundarySignals = 0;  // outputs that are read by another cluster
     };
 
+  private:
     std::unordered_map<std::string, size_t> _moduleIndexByName;
     std::vector<std::shared_ptr<Impl::ModuleBase>> _modules;
     std::vector<std::shared_ptr<VcdScope>> _scopes;
+    Impl::Worklist _worklist;
+    Impl::Netlist _netlist;
+    std::vector<signal_t> _signals;
+    std::vector<int> _alwaysUpdated;
+
+    // The signal arena and the netlist keep the order of the schedule they were
+    // built from, while the schedule itself may be rebuilt later on (see
+    // buildSignalArena() and buildNetlist())
+    std::vector<int> _signalOwner;        // module owning each signal of the arena
+    std::vector<size_t> _firstSignal;     // arena index of the first output of each module
+    std::vector<int> _slotReader;         // module (or the system) reading each input slot of the netlist
+    std::vector<size_t> _firstInputSlot;  // netlist row of the first input of each module
+    Statistics _stats;
+
+    // Parallel settling and clock dispatch share a pool of threads, see
+    // enableParallelSettle() and enableParallelClock()
+    std::unique_ptr<Impl::ThreadPool> _pool;
+    std::vector<Impl::Worklist> _localWorklists;
+    size_t _settleThreads = 1;
+    size_t _clockThreads = 1;
+    size_t _minParallelClock = 0;
+
+    // Partitioned settling, see partition()
+    size_t _nClusters = 1;
+    Partition _partition;
+    std::vector<size_t> _cluster;
+    std::vector<Impl::Worklist> _clusterWorklists;
+    std::vector<size_t> _clusterUpdates;
+    std::vector<signal_t> _mirror;
+    std::vector<signal_t const *> _boundarySources;
+    std::vector<int> _boundaryReaders;
+    std::vector<size_t> _boundaryOffsets;
+    std::vector<size_t> _levelStarts;
+    std::vector<bool> _levelCyclic;
+    std::vector<int> _batch;
+    size_t _minParallelLevel = 0;
+    std::vector<bool> _inLoop;
+    std::vector<bool> _clocked;  // modules with clock handlers, see init()
+
+    // Fused logic blocks, see fuseLogic()
+    bool _fuseLogic = false;
+    std::vector<Impl::LogicOp> _logicOps;
+    std::vector<int> _logicFanout;
+    std::vector<int> _logicPosition;
+    std::vector<int> _reconfigured;  // modules enabled or disabled since the last settle
+    std::vector<int> _wires;  // aliased wires monitored by a scope, see aliasWires()
+    std::vector<bool> _aliasedWires;  // wires whose readers read their drivers
+    std::vector<bool> _keptWires;     // wires put back in place after init(), see reconfigure()
+    Impl::Netlist _wiredNetlist;      // the netlist before aliasing the wires
+    size_t _maxTableBits = 16;
     
     Clock_ _clk;
     bool _initialized = false;
     size_t _moduleCount = 0;
     size_t _tickCount = 0;
     double _scopeFreq = 0;
+    std::unique_ptr<Impl::TraceStream> _stream;  // see streamVcd() and streamWaveform()
+
+    // Change-driven sampling of the scopes, see buildWatchers()
+    bool _watchChanges = false;      // only sample the signals reported while settling
+    bool _sampleAll = true;          // the next sample inspects every signal
+    std::vector<signal_t const *> _changedSignals;
+    std::vector<VcdScope::SignalLog *> _logs;  // the signals of all scopes, by index
+    std::vector<size_t> _watchers;             // logs monitoring each signal of the arena
+    std::vector<size_t> _watcherOffsets;
+    std::vector<size_t> _polledLogs;           // logs that are inspected on every sample
+    std::vector<size_t> _dirtyLogs;
 
     static constexpr char const *ANONYMOUS = "__rinku_anonymous";
     
@@ -353,12 +912,27 @@ namespace Rinku {
 
     void init();    
     signal_t run(bool resume = false);
-    bool halfStep(bool resume = false);    
+    virtual bool halfStep(bool resume = false);    
     bool step(bool resume = false);
     void updateAll();
+    void enableParallelSettle(size_t threads, size_t minLevelSize = 256);
+    void enableParallelClock(size_t threads, size_t minHandlers = 256);
+    void partition(size_t clusters);
+    Partition const &partitioning() const;
+    void fuseLogic(bool value = true);
+    void tabulatePureModules(size_t maxInputBits);
+
+    Statistics const &statistics() const;
+    void resetStatistics();
+    std::span<signal_t const> signals() const;
 
     template <typename ... Scopes>
     std::string vcd(Scopes const & ... args);
+    void streamVcd(std::string const &filename, size_t bufferSize = 1 << 16);
+
+    template <typename ... Scopes>
+    std::string waveform(Scopes const & ... args);
+    void streamWaveform(std::string const &filename, size_t blockSize = 1 << 18);
 
     std::vector<std::string> moduleNames() const;
 
@@ -382,14 +956,134 @@ namespace Rinku {
     signal_t const *getClockSignalPointer() const;
     
     void checkIfInitialized();
+    void buildSchedule();
+    void releaseGuarantees();
+    void resizePool();
+    void partitionModules();
+    void buildBoundary();
+    bool exchangeBoundary();
+    void buildLogicBlocks();
+    void reconfigure();
+    void buildTables();
+    void freezeConstants();
+    void aliasWires();
+    void refreshWires();
+    void buildWatchers();
+    void sampleScopes();
+    void evaluateLogic(size_t position);
+    void buildNetlist(std::unordered_map<signal_t const*, signal_t const*> const &moved);
+    std::unordered_map<signal_t const*, signal_t const*> buildSignalArena();
+    std::string vcdHeader() const;
+    std::string timescale() const;
+    std::vector<Waveform::Signal> waveformSignals(std::vector<VcdScope const *> const &scopes) const;
+
+    template <typename ... Scopes>
+    std::vector<VcdScope const *> selectScopes(Scopes const & ... args);
+
+    template <typename Emit>
+    static void mergeHistories(std::vector<VcdScope::SignalLog const *> const &logs, Emit &&emit);
+    
+    template <typename Update>
+    void settle(Update &&update);
+
+    template <typename Update>
+    void drainWorklist(Update &&update);
+
+    template <typename Update>
+    void drainLevels(Update &&update);
+
+    template <typename Update>
+    void drainClusters(Update &&update);
+
+  protected:
+    // Building blocks for systems that dispatch to their modules themselves
+    template <typename ModuleT, typename First, typename ... Rest>
+    static constexpr bool firstArgIsName();
+
+    template <typename ModuleT>
+    ModuleT& registerModule(std::shared_ptr<ModuleT> const &ptr, std::string const &name);
+
+    template <typename Update, typename Rise, typename Fall>
+    bool halfStep(bool resume, Update &&update, Rise &&rise, Fall &&fall);
+
+    void setClock(signal_t value);
+    bool parallelClock() const;
+    void riseParallel();
+    void fallParallel();
+    size_t moduleCount() const;
 
   }; // class System
 
 
+  // A system of which the module types are fixed at compile time. The modules
+  // are stored by value and must be added in the order in which their types are
+  // listed. Updates and clock edges are dispatched without virtual calls, so
+  // the compiler can inline the modules' update functions into the settle loop.
+  template <typename ... Modules>
+  class StaticSystem: public System {
+    static constexpr size_t N = sizeof ... (Modules);
+
+  public:
+    template <size_t I>
+    using ModuleAt = std::tuple_element_t<I, std::tuple<Modules ...>>;
+
+  private:
+    std::tuple<std::optional<Modules> ...> _slots;
+
+  public:
+    StaticSystem(double freq = 1);
+
+    template <typename ModuleT>
+    ModuleT& addModule();
+    
+    template <typename ModuleT, typename First, typename ... Rest>
+    ModuleT& addModule(First&& first, Rest&& ... rest);
+
+    template <typename ModuleT, typename... Args>
+    ModuleT& addModuleNamed(std::string const &name, Args&&... args);
+    
+    template <typename ModuleT, typename... Args>
+    ModuleT& addModuleUnnamed(Args&&... args);
+
+    template <size_t I>
+    ModuleAt<I> &get();
+
+    void init();
+    virtual bool halfStep(bool resume = false) override;
+
+  private:
+    template <typename ModuleT, typename... Args>
+    ModuleT& addModuleImpl(std::string const &name, Args&&... args);
+
+    template <size_t I, typename ModuleT, typename... Args>
+    ModuleT *emplace(Args&& ... args);
+
+    void updateModule(int idx, Impl::Worklist &worklist);
+    void riseAll();
+    void fallAll();
+    
+    template <size_t I>
+    void updateSlot(Impl::Worklist &worklist);
+
+    template <size_t I>
+    void riseSlot();
+
+    template <size_t I>
+    void fallSlot();
+    
+  }; // class StaticSystem
+  
+
   // Implementations
   #include "rinku_module.inl"
   #include "rinku_vcdscope.inl"
   #include "rinku_system.inl"
+  #include "rinku_partition.inl"
+  #include "rinku_logicblock.inl"
+  #include "rinku_wire.inl"
+  #include "rinku_sampling.inl"
+  #include "rinku_waveform.inl"
+  #include "rinku_staticsystem.inl"
   
 } // namespace Rinku
 
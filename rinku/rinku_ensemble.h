@@ -0,0 +1,171 @@
+#ifndef RINKU_ENSEMBLE_H
+#define RINKU_ENSEMBLE_H
+
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <functional>
+#include <exception>
+
+#include "rinku.h"
+
+namespace Rinku {
+
+  // An ensemble runs the same design for many different configurations (e.g.
+  // input programs) within one process. Every run builds its own system through
+  // the factory, so runs are independent and are spread over a pool of worker
+  // threads. Each worker starts out with a contiguous share of the runs and
+  // steals runs from the other workers when its own share is done.
+
+  enum class RunStatus {
+    Exit,        // SYS_EXIT was asserted
+    Error,       // SYS_ERR was asserted
+    CycleLimit,  // the maximum number of cycles was reached
+    Exception    // an exception was thrown while building or running the system
+  };
+
+  struct RunResult {
+    RunStatus status = RunStatus::Exception;
+    signal_t exitCode = 0;   // value of SYS_EXIT_CODE when the run ended
+    size_t cycles = 0;       // number of completed clock cycles
+    std::string vcd;         // only when VCD recording is enabled
+    std::string error;       // message of the exception, if any
+  };
+
+  template <typename Config>
+  class Ensemble {
+  public:
+    using Factory = std::function<std::unique_ptr<System>(Config const &)>;
+
+  private:
+    Factory _factory;
+    size_t _threads = std::max(std::thread::hardware_concurrency(), 1u);
+    size_t _maxCycles = -1;
+    bool _recordVcd = false;
+
+  public:
+    Ensemble(Factory factory);
+
+    Ensemble &threads(size_t n);
+    Ensemble &maxCycles(size_t n);
+    Ensemble &recordVcd(bool value = true);
+
+    std::vector<RunResult> run(std::vector<Config> const &configs) const;
+
+  private:
+    RunResult simulate(Config const &config) const;
+  };
+
+  template <typename Config>
+  Ensemble<Config>::Ensemble(Factory factory):
+    _factory(std::move(factory))
+  {}
+
+  template <typename Config>
+  Ensemble<Config> &Ensemble<Config>::threads(size_t n) {
+    _threads = std::max<size_t>(n, 1);
+    return *this;
+  }
+
+  template <typename Config>
+  Ensemble<Config> &Ensemble<Config>::maxCycles(size_t n) {
+    _maxCycles = n;
+    return *this;
+  }
+
+  template <typename Config>
+  Ensemble<Config> &Ensemble<Config>::recordVcd(bool value) {
+    _recordVcd = value;
+    return *this;
+  }
+
+  template <typename Config>
+  std::vector<RunResult> Ensemble<Config>::run(std::vector<Config> const &configs) const {
+    std::vector<RunResult> results(configs.size());
+    size_t const nThreads = std::min(_threads, configs.size());
+    if (nThreads <= 1) {
+      for (size_t idx = 0; idx != configs.size(); ++idx) {
+	results[idx] = simulate(configs[idx]);
+      }
+      return results;
+    }
+
+    // No runs are added once the workers have started, so a worker can stop
+    // as soon as it finds all queues empty.
+    struct Queue {
+      std::mutex mutex;
+      std::deque<size_t> runs;
+    };
+
+    std::vector<Queue> queues(nThreads);
+    for (size_t idx = 0; idx != configs.size(); ++idx) {
+      queues[idx * nThreads / configs.size()].runs.push_back(idx);
+    }
+
+    auto const take = [&](size_t self) -> std::optional<size_t> {
+      for (size_t offset = 0; offset != nThreads; ++offset) {
+	Queue &queue = queues[(self + offset) % nThreads];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.runs.empty()) continue;
+
+	// Own runs are taken from the front, stolen ones from the back
+	size_t idx;
+	if (offset == 0) {
+	  idx = queue.runs.front();
+	  queue.runs.pop_front();
+	}
+	else {
+	  idx = queue.runs.back();
+	  queue.runs.pop_back();
+	}
+	return idx;
+      }
+      return std::nullopt;
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t self = 0; self != nThreads; ++self) {
+      workers.emplace_back([&, self] {
+	while (std::optional<size_t> idx = take(self)) {
+	  results[*idx] = simulate(configs[*idx]);
+	}
+      });
+    }
+    for (std::thread &worker: workers) {
+      worker.join();
+    }
+
+    return results;
+  }
+
+  template <typename Config>
+  RunResult Ensemble<Config>::simulate(Config const &config) const {
+    RunResult result;
+    try {
+      std::unique_ptr<System> sys = _factory(config);
+      result.status = RunStatus::CycleLimit;
+      while (result.cycles != _maxCycles) {
+	if (!sys->step(true)) {
+	  result.status = sys->getInput<SYS_ERR>() ? RunStatus::Error : RunStatus::Exit;
+	  break;
+	}
+	++result.cycles;
+      }
+
+      result.exitCode = sys->getInput<SYS_EXIT_CODE>();
+      if (_recordVcd) result.vcd = sys->vcd();
+    }
+    catch (Error::Exception const &err) {
+      result.status = RunStatus::Exception;
+      result.error = err.what();
+    }
+    catch (std::exception const &err) {
+      result.status = RunStatus::Exception;
+      result.error = err.what();
+    }
+    return result;
+  }
+
+} // namespace Rinku
+
+#endif // RINKU_ENSEMBLE_H
@@ -88,6 +88,43 @@ struct DuplicateScopeNames: Exception {
   {}
 };
 
+struct VcdFileError: Exception {
+  VcdFileError(std::string const &filename):
+    Exception("Could not open \"", filename, "\" for writing the VCD stream.")
+  {}
+};
+
+struct WaveformFileError: Exception {
+  WaveformFileError(std::string const &filename):
+    Exception("Could not open waveform file \"", filename, "\".")
+  {}
+};
+
+struct InvalidWaveform: Exception {
+  InvalidWaveform(std::string const &filename, std::string const &reason):
+    Exception("\"", filename, "\" is not a valid waveform file: ", reason, ".")
+  {}
+};
+
+struct StaticModuleMismatch: Exception {
+  StaticModuleMismatch(size_t position, std::string const &type):
+    Exception("Module of type \"", type, "\" does not match position ", position,
+	      " in the module list of the StaticSystem.")
+  {}
+};
+
+struct StaticSystemIncomplete: Exception {
+  StaticSystemIncomplete(size_t added, size_t expected):
+    Exception("StaticSystem was initialized after adding ", added, " out of ", expected, " modules.")
+  {}
+};
+
+struct PartitionAfterInit: Exception {
+  PartitionAfterInit():
+    Exception("Cannot partition a system after call to System::init().")
+  {}
+};
+
 struct SystemFrequencyOutOfRange: Exception {
   SystemFrequencyOutOfRange(double f, double fMin, double fMax):
     Exception("System frequency (", f, " Hz) must be in range in range ",
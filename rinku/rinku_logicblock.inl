@@ -0,0 +1,120 @@
+// Fused logic blocks. Gates from the logic library (and any other module that
+// reports a GateKind) that are connected to each other form a block, which is
+// evaluated as a flat array of bitwise operations instead of one module update
+// per gate. The gates keep their outputs in the signal arena, so they can still
+// be inspected individually. When the worklist reaches a gate of a block, the
+// block is evaluated from that gate to its end in schedule order; gates further
+// down that were pending are taken off the worklist, because they are covered
+// by the same pass. Only modules outside the block are pushed when an output
+// changes.
+
+inline void System::fuseLogic(bool value) {
+  _fuseLogic = value;
+  if (_initialized) buildLogicBlocks();
+}
+
+inline void System::buildLogicBlocks() {
+  _logicOps.clear();
+  _logicFanout.clear();
+  _logicPosition.assign(_moduleCount, -1);
+  _stats.logicBlocks = 0;
+  _stats.fusedGates = 0;
+
+  // Concurrent settling visits the modules of a block out of order
+  if (!_fuseLogic || _settleThreads > 1 || _nClusters > 1) return;
+
+  // Gates that are part of a combinational loop are updated as usual, frozen
+  // gates are not evaluated at all
+  size_t const n = _moduleCount;
+  std::vector<Impl::LogicOp> ops(n);
+  std::vector<bool> fusable(n, false);
+  for (size_t idx = 0; idx != n; ++idx) {
+    Impl::ModuleBase const &m = *_modules[idx];
+    fusable[idx] = !_inLoop[idx] && m.updateEnabled() && !m.frozen() && m.logicOp(ops[idx]);
+  }
+
+  // Connected gates end up in the same block
+  std::vector<int> block(n);
+  std::iota(block.begin(), block.end(), 0);
+  auto const find = [&](int v) {
+    while (block[v] != v) v = block[v] = block[block[v]];
+    return v;
+  };
+
+  std::vector<std::vector<int>> readers(n);
+  for (size_t idx = 0; idx != n; ++idx) {
+    if (!fusable[idx]) continue;
+    readers[idx] = _modules[idx]->outgoingModules();
+    for (int next: readers[idx]) {
+      if (next >= 0 && fusable[next]) block[find(next)] = find(idx);
+    }
+  }
+
+  // Lay out the blocks one after the other, each in schedule order
+  std::vector<std::vector<int>> members(n);
+  for (int idx: _worklist.schedule()) {
+    if (fusable[idx]) members[find(idx)].push_back(idx);
+  }
+
+  for (std::vector<int> const &gates: members) {
+    if (gates.empty()) continue;
+
+    size_t const begin = _logicOps.size();
+    for (int idx: gates) {
+      Impl::LogicOp op = ops[idx];
+      op.fanoutBegin = _logicFanout.size();
+      for (int next: readers[idx]) {
+	if (next < 0 || (fusable[next] && find(next) == find(idx))) continue;
+	_logicFanout.push_back(next);
+      }
+      op.fanoutEnd = _logicFanout.size();
+      size_t const signal = op.out - _signals.data();
+      op.watched = _watcherOffsets[signal] != _watcherOffsets[signal + 1];
+      _logicPosition[idx] = _logicOps.size();
+      _logicOps.push_back(op);
+    }
+    for (size_t pos = begin; pos != _logicOps.size(); ++pos) {
+      _logicOps[pos].end = _logicOps.size();
+    }
+    ++_stats.logicBlocks;
+  }
+  _stats.fusedGates = _logicOps.size();
+}
+
+inline void System::evaluateLogic(size_t position) {
+  auto const read = [](Impl::InputPath const &path) -> signal_t {
+    switch (path.kind) {
+    case Impl::InputPath::Single:         return *path.ptr | path.constant;
+    case Impl::InputPath::SingleInverted: return ~(*path.ptr) | path.constant;
+    default:                              return path.constant;
+    }
+  };
+
+  Impl::LogicOp const *op = _logicOps.data() + position;
+  Impl::LogicOp const *const end = _logicOps.data() + op->end;
+  for (; op != end; ++op) {
+    _worklist.erase(op->module);
+
+    signal_t const a = read(op->a);
+    signal_t const b = read(op->b);
+    signal_t value;
+    switch (op->kind) {
+    case Impl::GateKind::And:  value = a & b;    break;
+    case Impl::GateKind::Or:   value = a | b;    break;
+    case Impl::GateKind::Xor:  value = a ^ b;    break;
+    case Impl::GateKind::Nand: value = ~(a & b); break;
+    case Impl::GateKind::Nor:  value = ~(a | b); break;
+    case Impl::GateKind::Xnor: value = ~(a ^ b); break;
+    default:                   value = 0;        break;
+    }
+
+    value &= op->mask;
+    if (value == *op->out) continue;
+
+    *op->out = value;
+    if (op->watched) _changedSignals.push_back(op->out);
+    for (uint32_t r = op->fanoutBegin; r != op->fanoutEnd; ++r) {
+      _worklist.push(_logicFanout[r]);
+    }
+  }
+}
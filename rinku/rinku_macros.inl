@@ -16,7 +16,12 @@
 #define RINKU_ON_CLOCK_RISING() virtual void clockRising() override
 #define RINKU_ON_CLOCK_FALLING() virtual void clockFalling() override
 #define RINKU_UPDATE() virtual void update([[maybe_unused]] GuaranteeToken guarantee_no_get_input) override
+#define RINKU_PURE_UPDATE() static constexpr bool PureUpdate = true; RINKU_UPDATE()
 #define RINKU_GUARANTEE_NO_GET_INPUT() guarantee_no_get_input.set();
+#define RINKU_EVENT_DRIVEN() static constexpr bool EventDriven = true
+#define RINKU_SERIAL_CLOCK() static constexpr bool SerialClock = true
+#define RINKU_NO_LOOKUP_TABLE() static constexpr bool NoLookupTable = true
+#define RINKU_STATE_CHANGED() stateChanged()
 #define RINKU_RESET() virtual void reset() override
 #define RINKU_NOT(SIGNAL) Rinku::Not<SIGNAL>
 
@@ -86,6 +91,7 @@
 #define ON_CLOCK_RISING RINKU_ON_CLOCK_RISING 
 #define ON_CLOCK_FALLING RINKU_ON_CLOCK_FALLING
 #define UPDATE RINKU_UPDATE
+#define PURE_UPDATE RINKU_PURE_UPDATE
 #define RESET RINKU_RESET
 #define NOT RINKU_NOT
 #define ADD_MODULE RINKU_ADD_MODULE
@@ -101,4 +107,8 @@
 #define GET_INPUT RINKU_GET_INPUT
 #define GET_INPUT_INDEX RINKU_GET_INPUT_INDEX
 #define GUARANTEE_NO_GET_INPUT RINKU_GUARANTEE_NO_GET_INPUT
+#define EVENT_DRIVEN RINKU_EVENT_DRIVEN
+#define SERIAL_CLOCK RINKU_SERIAL_CLOCK
+#define NO_LOOKUP_TABLE RINKU_NO_LOOKUP_TABLE
+#define STATE_CHANGED RINKU_STATE_CHANGED
 #endif
@@ -9,38 +9,298 @@ void Module<T1, T2>::addOutgoing(size_t outputIndex, int idx) {
 
 template <typename T1, typename T2>
 bool Module<T1, T2>::connected(size_t inputIndex, signal_t const *ptr) {
-  for (auto const &pr: inputState[inputIndex])
-    if (pr.first == ptr) 
+  for (auto const &driver: inputState[inputIndex])
+    if (driver.ptr == ptr) 
       return true;
   return false;
 }
 
 
 template <typename T1, typename T2>
-std::vector<int> const &Module<T1, T2>::outgoing(size_t outputIndex) {
-  return outputModules[outputIndex];
+std::span<int const> Module<T1, T2>::outgoing(size_t outputIndex) const {
+  if (!fanout) return outputModules[outputIndex];
+  return {fanout + fanoutOffsets[outputIndex], fanout + fanoutOffsets[outputIndex + 1]};
 }
 
 template <typename T1, typename T2>
-std::vector<int> Module<T1, T2>::updateAndCheck() {
-  if (guaranteed() || not updateEnabled()) return {};
-      
-  signal_t oldOutputs[Outputs::N];
+std::span<Impl::Driver const> Module<T1, T2>::incoming(size_t inputIndex) const {
+  if (!drivers) return inputState[inputIndex];
+  return {drivers + driverOffsets[inputIndex], drivers + driverOffsets[inputIndex + 1]};
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::addToNetlist(Impl::Netlist &netlist) {
+  for (size_t idx = 0; idx != Inputs::N; ++idx) {
+    size_t const slot = netlist.addInput(inputState[idx]);
+    if (idx == 0) inputSlot = slot;
+  }
+  for (size_t idx = 0; idx != Outputs::N; ++idx) {
+    size_t const slot = netlist.addOutput(outputModules[idx]);
+    if (idx == 0) outputSlot = slot;
+  }
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::moveOutputs(signal_t *storage, std::unordered_map<signal_t const*, signal_t const*> &moved) {
   for (size_t idx = 0; idx != Outputs::N; ++idx) {
-    oldOutputs[idx] = outputState[idx];
+    storage[idx] = outputs[idx];
+    moved[&outputState[idx]] = &storage[idx];
+    moved[&outputs[idx]] = &storage[idx];
   }
+  outputs = storage;
+}
 
-  this->update();
+template <typename T1, typename T2>
+void Module<T1, T2>::bindNetlist(Impl::Netlist const &netlist) {
+  size_t const *inputRows = netlist.driverOffsets() + inputSlot;
+  drivers = netlist.drivers() + inputRows[0];
+  for (size_t idx = 0; idx != Inputs::N + 1; ++idx) {
+    driverOffsets[idx] = inputRows[idx] - inputRows[0];
+  }
 
-  std::vector<int> affected;
+  // Pick the cheapest way to read each input. Constant drivers are not part
+  // of the rows; the netlist keeps their values folded into one per input.
+  for (size_t idx = 0; idx != Inputs::N; ++idx) {
+    Impl::InputPath &path = inputPaths[idx];
+    path.constant = netlist.constants()[inputSlot + idx] & Inputs::masks()[idx];
+
+    std::span<Impl::Driver const> const row = incoming(idx);
+    path.ptr = row.empty() ? nullptr : row[0].ptr;
+    path.kind =
+      row.empty()                         ? Impl::InputPath::Constant :
+      row.size() > 1 || !row[0].direct()  ? Impl::InputPath::Multi :
+      row[0].activeLow                    ? Impl::InputPath::SingleInverted :
+      Impl::InputPath::Single;
+  }
+
+  size_t const *outputRows = netlist.fanoutOffsets() + outputSlot;
+  fanout = netlist.fanout() + outputRows[0];
+  for (size_t idx = 0; idx != Outputs::N + 1; ++idx) {
+    fanoutOffsets[idx] = outputRows[idx] - outputRows[0];
+  }
+  forgetInputs();
+}
+
+template <typename T1, typename T2>
+bool Module<T1, T2>::tabulate(size_t maxInputBits) {
+  // Evaluate the update of a pure module for every combination of input
+  // values and store the resulting outputs in a table, one row per
+  // combination. The inputs are concatenated into the row index, the first
+  // input in the least significant bits. The update is called 2^bits times,
+  // including for combinations that never occur while running, so it must
+  // have no side effects (see PURE_UPDATE() in the readme).
+  table = nullptr;
+  tableStorage.clear();
+  if constexpr (Inputs::N != 0 && Outputs::N != 0) {
+    size_t bits = 0;
+    for (size_t idx = 0; idx != Inputs::N; ++idx) {
+      bits += Inputs::widths()[idx];
+    }
+    if (bits > maxInputBits || bits >= 64) return false;
+
+    // The inputs are temporarily replaced by constants
+    std::array<Impl::InputPath, Inputs::N> const paths = std::to_array(inputPaths);
+    std::array<signal_t, Outputs::N> state;
+    std::copy(outputs, outputs + Outputs::N, state.begin());
+    std::array<uint64_t, std::max<size_t>(ChangedWords, 1)> const changed = std::to_array(changedOutputs);
+
+    bool ok = true;
+    size_t const rows = size_t(1) << bits;
+    tableStorage.resize(rows * Outputs::N);
+    try {
+      for (size_t row = 0; row != rows; ++row) {
+	size_t shift = 0;
+	for (size_t idx = 0; idx != Inputs::N; ++idx) {
+	  inputPaths[idx].kind = Impl::InputPath::Constant;
+	  inputPaths[idx].constant = (row >> shift) & Inputs::masks()[idx];
+	  shift += Inputs::widths()[idx];
+	}
+	ModuleBase::template updateAs<ModuleBase>(nullptr);
+	std::copy(outputs, outputs + Outputs::N, tableStorage.begin() + row * Outputs::N);
+      }
+    }
+    catch (...) {
+      // Modules that throw for some of their inputs are updated as usual
+      ok = false;
+      tableStorage.clear();
+    }
+
+    std::copy(paths.begin(), paths.end(), inputPaths);
+    std::copy(state.begin(), state.end(), outputs);
+    std::copy(changed.begin(), changed.end(), changedOutputs);
+    resetGuaranteed();
+
+    if (ok) table = tableStorage.data();
+  }
+  return table != nullptr;
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::forgetInputs() {
+  // The next update of a pure module takes place even if its inputs are the
+  // same as before
+  inputsKnown = false;
+}
+
+template <typename T1, typename T2>
+bool Module<T1, T2>::wireTerms(size_t output, std::vector<WireTerm> &terms) const {
+  // The terms given by wiring() with the widths of the inputs and the output
+  // folded into their masks
+  size_t const first = terms.size();
+  if (!this->wiring(output, terms)) return false;
+  
+  if constexpr (Inputs::N != 0 && Outputs::N != 0) {
+    for (size_t idx = first; idx != terms.size(); ++idx) {
+      WireTerm &term = terms[idx];
+      assert(term.input < Inputs::N && term.shift < 64 && term.offset < 64 && "invalid wire term");
+      term.mask &= (Inputs::masks()[term.input] >> term.shift) & (Outputs::masks()[output] >> term.offset);
+    }
+  }
+  else {
+    terms.resize(first);
+  }
+  return true;
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::watchOutput(signal_t const *ptr, std::vector<signal_t const *> *changes) {
+  // From now on, updateAndCheck() appends the output to the given vector
+  // whenever it takes a new value
+  size_t const idx = ptr - outputs;
+  assert(idx < Outputs::N && "not an output of this module");
+  watchedOutputs[idx >> 6] |= (uint64_t(1) << (idx & 63));
+  changeLog = changes;
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::unwatchOutputs() {
+  std::fill(std::begin(watchedOutputs), std::end(watchedOutputs), 0);
+  changeLog = nullptr;
+}
+
+template <typename T1, typename T2>
+signal_t Module<T1, T2>::wireOutput(size_t outputIndex) const {
+  // The masks of the terms include the widths of the inputs and the output
+  signal_t value = 0;
+  if constexpr (Inputs::N != 0) {
+    for (WireTerm const &term: aliasTerms(outputIndex)) {
+      value |= ((readInput(term.input) >> term.shift) & term.mask) << term.offset;
+    }
+  }
+  return value;
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::refreshWire() {
+  // Bring the outputs of an aliased wire up to date without calling its
+  // update, which would set the outputs as if from outside (see setOutput())
   for (size_t idx = 0; idx != Outputs::N; ++idx) {
-    if (oldOutputs[idx] != outputState[idx]) {
-      auto const &outVec = outgoing(idx);
-      affected.insert(affected.end(), outVec.begin(), outVec.end());
+    writeOutput(idx, wireOutput(idx));
+  }
+}
+
+template <typename T1, typename T2>
+bool Module<T1, T2>::inputsChanged() {
+  bool changed = !inputsKnown;
+  for (size_t idx = 0; idx != Inputs::N; ++idx) {
+    signal_t const value = readInput(idx);
+    if (value != lastInputs[idx]) {
+      lastInputs[idx] = value;
+      changed = true;
     }
   }
+  inputsKnown = true;
+  return changed;
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::lookup() {
+  // Only called for pure modules, right after inputsChanged()
+  size_t row = 0;
+  size_t shift = 0;
+  for (size_t idx = 0; idx != Inputs::N; ++idx) {
+    row |= size_t(lastInputs[idx]) << shift;
+    shift += Inputs::widths()[idx];
+  }
 
-  return affected;
+  signal_t const *values = table + row * Outputs::N;
+  for (size_t idx = 0; idx != Outputs::N; ++idx) {
+    writeOutput(idx, values[idx]);
+  }
+}
+
+template <typename T1, typename T2>
+bool Module<T1, T2>::logicOp(Impl::LogicOp &op) const {
+  // Only gates of which both inputs can be read without visiting the netlist
+  if constexpr (Inputs::N == 2 && Outputs::N == 1) {
+    if (gateKind() == Impl::GateKind::None) return false;
+    if (inputPaths[0].kind == Impl::InputPath::Multi || inputPaths[1].kind == Impl::InputPath::Multi) return false;
+
+    op.a = inputPaths[0];
+    op.b = inputPaths[1];
+    op.out = outputs;
+    op.mask = Outputs::masks()[0];
+    op.kind = gateKind();
+    op.module = getModuleIndex();
+    return true;
+  }
+  return false;
+}
+
+template <typename T1, typename T2>
+std::vector<int> Module<T1, T2>::outgoingModules() const {
+  std::vector<int> result;
+  for (size_t idx = 0; idx != Outputs::N; ++idx) {
+    std::span<int const> const readers = outgoing(idx);
+    result.insert(result.end(), readers.begin(), readers.end());
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::updateAndCheck(Impl::Worklist &worklist) {
+  updateAndCheckAs<Impl::ModuleBase>(worklist);
+}
+
+template <typename T1, typename T2>
+template <typename ModuleT>
+void Module<T1, T2>::updateAndCheckAs(Impl::Worklist &worklist) {
+  // Aliased wires are not updated while settling, see System::aliasWires()
+  if (aliased()) return;
+
+  // A pure module that sees the same inputs as before would produce the same
+  // outputs, so its update can be skipped. Frozen modules never see new inputs,
+  // and are only updated again after forgetInputs(). Disabled modules and
+  // modules that guaranteed not to read their inputs are not updated, but
+  // outputs that were set from outside are passed on below.
+  if (!guaranteed() && updateEnabled() &&
+      (!pureUpdate() || ((!frozen() || !inputsKnown) && inputsChanged()))) {
+    if (table) lookup();
+    else ModuleBase::template updateAs<ModuleT>(&worklist);
+  }
+
+  // Only visit the fanout of outputs that were changed by setOutput(). This
+  // includes outputs that were changed from outside the system since the last
+  // update of this module. Outputs monitored by a scope are reported to the
+  // system, which only samples those (see System::buildWatchers()).
+  for (size_t word = 0; word != ChangedWords; ++word) {
+    uint64_t changed = changedOutputs[word];
+    changedOutputs[word] = 0;
+
+    for (uint64_t watched = changed & watchedOutputs[word]; watched; watched &= (watched - 1)) {
+      changeLog->push_back(outputs + (word << 6) + std::countr_zero(watched));
+    }
+    
+    while (changed) {
+      size_t const idx = (word << 6) + std::countr_zero(changed);
+      changed &= (changed - 1);
+      for (int moduleIndex: outgoing(idx)) {
+	worklist.push(moduleIndex);
+      }
+    }
+  }
 }
 
 template <typename T1, typename T2>
@@ -83,7 +343,7 @@ template <typename InputSignal, signal_t Value>
 void Module<T1, T2>::connect() {
   static signal_t const value = Value;
 
-  static_assert(Value < (1 << InputSignal::Width),
+  static_assert(Value <= InputSignal::Mask,
 		"Constant input value too large for signal-width.");
 
   Error::throw_runtime_error_if
@@ -93,7 +353,7 @@ void Module<T1, T2>::connect() {
   constexpr size_t inputIndex = index_of<InputSignal>;
 
   if (connected(inputIndex, ptr)) return;
-  inputState[inputIndex].push_back({ptr, false});
+  inputState[inputIndex].push_back({ptr, false, true});
   addDotConnection<InputSignal, Value>();
   ModuleBase::addHardwiredValue(Value);
 }
@@ -103,8 +363,12 @@ template <typename S>
 void Module<T1, T2>::setOutput(signal_t value) {
   static_assert(S::IsOutput,
 		"Signal passed to setOutput is not an output signal.");
-      
-  setOutput(index_of<S>, value);
+
+  Error::throw_runtime_error_if
+    <Error::OutputChangeNotAllowed>(!setOutputAllowed(), ModuleBase::name());
+
+  if (!updating()) outsideWrite();
+  writeOutput(index_of<S>, value);
 }
 
 template <typename T1, typename T2>
@@ -123,7 +387,17 @@ void Module<T1, T2>::setOutput(size_t outputIndex, signal_t value) {
   Error::throw_runtime_error_if
     <Error::IndexOutOfBounds>(outputIndex >= Outputs::N, "output", ModuleBase::name(), outputIndex, Outputs::N);
 
-  outputState[outputIndex] = value & Outputs::masks()[outputIndex];
+  if (!updating()) outsideWrite();
+  writeOutput(outputIndex, value);
+}
+
+template <typename T1, typename T2>
+void Module<T1, T2>::writeOutput(size_t outputIndex, signal_t value) {
+  signal_t const masked = value & Outputs::masks()[outputIndex];
+  if (outputs[outputIndex] != masked) {
+    outputs[outputIndex] = masked;
+    changedOutputs[outputIndex >> 6] |= (uint64_t(1) << (outputIndex & 63));
+  }
 }
 
 template <typename T1, typename T2>
@@ -142,7 +416,7 @@ signal_t Module<T1, T2>::getInput() const {
   static_assert(S::IsInput,
 		"Signal passed to getInput is not an input-signal.");
       
-  return getInput(index_of<S>);
+  return readInput(index_of<S>);
 }
 
 template <typename T1, typename T2>
@@ -157,10 +431,28 @@ template <typename T1, typename T2>
 signal_t Module<T1, T2>::getInput(size_t inputIndex) const {
   Error::throw_runtime_error_if
     <Error::IndexOutOfBounds>(inputIndex >= Inputs::N, "input", ModuleBase::name(), inputIndex, Inputs::N);
-      
-  signal_t result = 0;
-  for (auto const &[ptr, activeLow]: inputState[inputIndex]) {
-    if (ptr) result |= (activeLow ? ~(*ptr) : *ptr);
+
+  return readInput(inputIndex);
+}
+
+template <typename T1, typename T2>
+signal_t Module<T1, T2>::readInput(size_t inputIndex) const {
+  Impl::InputPath const &path = inputPaths[inputIndex];
+  signal_t const mask = Inputs::masks()[inputIndex];
+
+  switch (path.kind) {
+  case Impl::InputPath::Constant:       return path.constant;
+  case Impl::InputPath::Single:         return (*path.ptr | path.constant) & mask;
+  case Impl::InputPath::SingleInverted: return (~(*path.ptr) | path.constant) & mask;
+  default:                              return readMultiInput(inputIndex);
+  }
+}
+
+template <typename T1, typename T2>
+signal_t Module<T1, T2>::readMultiInput(size_t inputIndex) const {
+  signal_t result = inputPaths[inputIndex].constant;
+  for (auto const &driver: incoming(inputIndex)) {
+    result |= driver.value();
   }
   return result & Inputs::masks()[inputIndex];
 }
@@ -177,8 +469,11 @@ template <typename T1, typename T2>
 signal_t Module<T1, T2>::getOutput(size_t outputIndex) const {
   Error::throw_runtime_error_if
     <Error::IndexOutOfBounds>(outputIndex >= Outputs::N, "output", ModuleBase::name(), outputIndex, Outputs::N);
-      
-  return outputState[outputIndex] & Outputs::masks()[outputIndex];
+
+  // The outputs of wires whose readers read their drivers are not kept up to
+  // date, and are derived from the inputs instead
+  if (aliased() && updateEnabled()) return wireOutput(outputIndex);
+  return outputs[outputIndex] & Outputs::masks()[outputIndex];
 }
 
 template <typename T1, typename T2>
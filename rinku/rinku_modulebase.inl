@@ -3,7 +3,30 @@ inline ModuleBase::ModuleBase() {
 }
 
 inline void ModuleBase::update() {
-  this->update(GuaranteeToken{&_guaranteed});
+  updateAs<ModuleBase>(_worklist);
+}
+
+template <typename ModuleT>
+void ModuleBase::updateAs(Worklist *worklist) {
+  // Call the update of ModuleT directly when possible, so that it can be
+  // inlined. Otherwise (or when ModuleT is ModuleBase) use virtual dispatch.
+  GuaranteeToken token{&_guaranteed};
+  struct Updating {
+    bool &flag;
+    Updating(bool &f): flag(f) { flag = true; }
+    ~Updating() { flag = false; }
+  } const updating{_updating};
+  
+  if constexpr (!std::is_same_v<ModuleT, ModuleBase> &&
+		requires (ModuleT &m, GuaranteeToken t) { m.ModuleT::update(t); }) {
+    static_cast<ModuleT*>(this)->ModuleT::update(token);
+  }
+  else {
+    this->update(token);
+  }
+
+  // Guarantees are released at the next clock edge
+  if (_guaranteed && worklist) worklist->guarantee(_index);
 }
 
 inline void ModuleBase::setModuleIndex(int idx) {
@@ -24,7 +47,92 @@ inline std::string const &ModuleBase::name() const {
 }
 
 inline void ModuleBase::enableUpdate(bool val) {
+  // The readers of a disabled wire must see the outputs it keeps. The system
+  // may have to adapt to the change before it settles again.
+  if (!val) unalias();
+  if (val != _updateEnabled && _reconfigured) _reconfigured->push_back(_index);
   _updateEnabled = val;
+
+  // Outputs may be stale after having been disabled, even if the inputs of a
+  // pure module are the same as before
+  if (val) {
+    forgetInputs();
+    stateChanged();
+  }
+}
+
+inline void ModuleBase::setEventDriven(bool val) {
+  _eventDriven = val;
+}
+
+inline bool ModuleBase::eventDriven() const {
+  return _eventDriven;
+}
+
+inline void ModuleBase::setPureUpdate(bool val) {
+  _pureUpdate = val;
+}
+
+inline bool ModuleBase::pureUpdate() const {
+  return _pureUpdate;
+}
+
+inline void ModuleBase::allowTable(bool val) {
+  _tableAllowed = val;
+}
+
+inline bool ModuleBase::tableAllowed() const {
+  return _tableAllowed;
+}
+
+inline void ModuleBase::freeze() {
+  _frozen = true;
+}
+
+inline void ModuleBase::unfreeze() {
+  _frozen = false;
+}
+
+inline bool ModuleBase::frozen() const {
+  return _frozen;
+}
+
+inline void ModuleBase::alias(std::vector<std::vector<WireTerm>> terms) {
+  _aliased = true;
+  _aliasTerms = std::move(terms);
+}
+
+inline void ModuleBase::unalias() {
+  // Called when the outputs of a wire are about to be set from outside or its
+  // updates are disabled: its outputs are brought up to date first, and the
+  // system points the readers of the wire back at these outputs before it
+  // settles again (see System::reconfigure()).
+  if (!_aliased) return;
+
+  refreshWire();
+  _aliased = false;
+  _aliasTerms.clear();
+  if (_reconfigured) _reconfigured->push_back(_index);
+}
+
+inline bool ModuleBase::aliased() const {
+  return _aliased;
+}
+
+inline std::vector<ModuleBase::WireTerm> const &ModuleBase::aliasTerms(size_t output) const {
+  return _aliasTerms[output];
+}
+
+inline void ModuleBase::setWorklist(Worklist *worklist) {
+  _worklist = worklist;
+}
+
+inline void ModuleBase::setReconfigurationLog(std::vector<int> *log) {
+  _reconfigured = log;
+}
+
+inline void ModuleBase::stateChanged() {
+  if (_worklist && _updateEnabled) _worklist->notify(_index);
 }
       
 inline void ModuleBase::lock() {
@@ -55,6 +163,25 @@ inline bool ModuleBase::updateEnabled() const {
   return _updateEnabled;
 }
 
+inline bool ModuleBase::updating() const {
+  return _updating;
+}
+
+inline void ModuleBase::outsideWrite() {
+  // Called by setOutput() when the outputs are set from outside the system,
+  // for example by the debugger's poke, rather than by the update. An aliased
+  // wire is put back in place, and the next update of the module takes place
+  // even if it is pure and its inputs did not change. The modules frozen
+  // along with a frozen module must see its new outputs (see
+  // System::reconfigure()). The module is put on the worklist even when it is
+  // disabled, so that the new outputs reach its readers and the scopes
+  // monitoring them on the next settle.
+  unalias();
+  forgetInputs();
+  if (_worklist) _worklist->notify(_index);
+  if (_frozen && _reconfigured) _reconfigured->push_back(_index);
+}
+
 inline void ModuleBase::addDotConnection(std::string const &str) {
   _dotConnections.push_back(str);
 }
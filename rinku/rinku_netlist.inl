@@ -0,0 +1,113 @@
+// The netlist holds all connections of a system after System::init() in
+// compressed sparse row format: the drivers of every input are stored
+// contiguously in one array and the fanout of every output in another. Each
+// input (output) of each module occupies a slot; the drivers (fanout) of slot i
+// are found between offsets i and i + 1. Modules keep pointers into these
+// arrays, so reading inputs and propagating changes walks contiguous memory
+// instead of one heap-allocated vector per signal.
+
+inline signal_t Driver::value() const {
+  return select(activeLow ? ~(*ptr) : *ptr);
+}
+
+inline signal_t Driver::select(signal_t value) const {
+  return ((value >> shift) & mask) << offset;
+}
+
+inline bool Driver::narrow(size_t nextShift, size_t nextOffset, signal_t nextMask) {
+  // Merge a selection of the bits that this driver delivers into its own
+  // selection. Returns false when no bits are left.
+  signal_t const all = ~signal_t(0);
+  if (offset >= nextShift) {
+    size_t const up = offset - nextShift;
+    mask &= (all >> offset) & (nextMask >> up);
+    if (up + nextOffset >= 64) return false;
+    offset = up + nextOffset;
+  }
+  else {
+    size_t const down = nextShift - offset;
+    if (shift + down >= 64) return false;
+    mask = (mask >> down) & (all >> nextShift) & nextMask;
+    shift += down;
+    offset = nextOffset;
+  }
+
+  // Shift in one direction only, so that drivers that select different bits
+  // of the same signal can be merged
+  mask &= all >> shift;
+  if (shift >= offset) {
+    shift -= offset;
+    mask <<= offset;
+    offset = 0;
+  }
+  else {
+    offset -= shift;
+    mask <<= shift;
+    shift = 0;
+  }
+  return mask != 0;
+}
+
+inline bool Driver::direct() const {
+  return shift == 0 && offset == 0 && mask == ~signal_t(0);
+}
+
+inline size_t Netlist::addInput(std::vector<Driver> const &drivers, signal_t constant) {
+  // Constant drivers are folded into a single value per input
+  for (Driver const &driver: drivers) {
+    if (driver.constant) constant |= *driver.ptr;
+    else _drivers.push_back(driver);
+  }
+  _constants.push_back(constant);
+  _driverOffsets.push_back(_drivers.size());
+  return _driverOffsets.size() - 2;
+}
+
+inline size_t Netlist::addOutput(std::vector<int> const &fanout) {
+  _fanout.insert(_fanout.end(), fanout.begin(), fanout.end());
+  _fanoutOffsets.push_back(_fanout.size());
+  return _fanoutOffsets.size() - 2;
+}
+
+inline void Netlist::relocate(std::unordered_map<signal_t const*, signal_t const*> const &moved) {
+  for (Driver &driver: _drivers) {
+    auto const it = moved.find(driver.ptr);
+    if (it != moved.end()) driver.ptr = it->second;
+  }
+}
+
+inline void Netlist::clear() {
+  _drivers.clear();
+  _driverOffsets.assign(1, 0);
+  _fanout.clear();
+  _fanoutOffsets.assign(1, 0);
+  _constants.clear();
+}
+
+inline std::span<Driver> Netlist::inputRow(size_t slot) {
+  return {_drivers.data() + _driverOffsets[slot], _drivers.data() + _driverOffsets[slot + 1]};
+}
+
+inline std::span<int const> Netlist::fanoutRow(size_t slot) const {
+  return {_fanout.data() + _fanoutOffsets[slot], _fanout.data() + _fanoutOffsets[slot + 1]};
+}
+
+inline Driver const *Netlist::drivers() const {
+  return _drivers.data();
+}
+
+inline size_t const *Netlist::driverOffsets() const {
+  return _driverOffsets.data();
+}
+
+inline int const *Netlist::fanout() const {
+  return _fanout.data();
+}
+
+inline size_t const *Netlist::fanoutOffsets() const {
+  return _fanoutOffsets.data();
+}
+
+inline signal_t const *Netlist::constants() const {
+  return _constants.data();
+}
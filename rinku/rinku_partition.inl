@@ -0,0 +1,282 @@
+// Partitioned settling. The modules are divided into clusters with as few
+// connections between them as possible, and each cluster is settled by its own
+// thread. A module never reads an output of another cluster directly: those
+// inputs are redirected to a mirror of the output, which is only updated in
+// between rounds. During a round, every cluster settles against the mirrored
+// values of its boundary inputs. At the end of the round, the outputs that are
+// read by other clusters are compared to their mirrors; changed values are
+// copied into the mirror and the reading modules are put on the worklist of
+// their cluster. The system has settled when a round leaves all mirrors
+// unchanged. Clusters synchronize once per round instead of once per level, so
+// deep designs with few connections between the clusters need few rounds.
+
+inline void System::partition(size_t clusters) {
+  Error::throw_runtime_error_if
+    <Error::PartitionAfterInit>(_initialized);
+
+  _nClusters = std::max<size_t>(clusters, 1);
+  resizePool();
+}
+
+inline System::Partition const &System::partitioning() const {
+  return _partition;
+}
+
+inline void System::partitionModules() {
+  // Min-cut heuristic. The clusters are first grown from seeds that lie as far
+  // apart as possible in the undirected connection graph, each claiming its
+  // unclaimed neighbours in breadth-first order until it is full. Modules are
+  // then moved to the cluster they have the most connections with, as long as
+  // this lowers the number of connections between clusters and keeps the
+  // clusters balanced. Finally, the modules are assigned along the direction
+  // in which signals flow (see below).
+  size_t const n = _moduleCount;
+  size_t const k = std::min(_nClusters, std::max<size_t>(n, 1));
+  std::vector<std::vector<int>> neighbours(n);
+  for (size_t v = 0; v != n; ++v) {
+    for (int w: _modules[v]->outgoingModules()) {
+      if (w < 0 || w == int(v)) continue;
+      neighbours[v].push_back(w);
+      neighbours[w].push_back(v);
+    }
+  }
+
+  // Each seed is the module furthest away from all previous seeds
+  static constexpr size_t UNREACHED = -1;
+  std::vector<size_t> distance(n, UNREACHED);
+  std::vector<int> queue;
+  std::vector<int> seeds;
+  auto const spread = [&](int seed) {
+    queue.assign(1, seed);
+    distance[seed] = 0;
+    for (size_t head = 0; head != queue.size(); ++head) {
+      int const v = queue[head];
+      for (int w: neighbours[v]) {
+	if (distance[w] <= distance[v] + 1) continue;
+	distance[w] = distance[v] + 1;
+	queue.push_back(w);
+      }
+    }
+  };
+  
+  for (int seed = 0; n != 0 && seeds.size() != k; ) {
+    seeds.push_back(seed);
+    spread(seed);
+    seed = std::max_element(distance.begin(), distance.end()) - distance.begin();
+    if (distance[seed] == UNREACHED) {
+      // Next component
+      seed = std::find(distance.begin(), distance.end(), UNREACHED) - distance.begin();
+    }
+  }
+
+  static constexpr size_t UNASSIGNED = -1;
+  size_t const capacity = (n + k - 1) / k;
+  std::vector<size_t> sizes(k, 0);
+  _cluster.assign(n, UNASSIGNED);
+  queue.clear();
+  for (size_t c = 0; c != seeds.size(); ++c) {
+    _cluster[seeds[c]] = c;
+    ++sizes[c];
+    queue.push_back(seeds[c]);
+  }
+  for (size_t head = 0; head != queue.size(); ++head) {
+    int const v = queue[head];
+    size_t const c = _cluster[v];
+    for (int w: neighbours[v]) {
+      if (_cluster[w] != UNASSIGNED || sizes[c] == capacity) continue;
+      _cluster[w] = c;
+      ++sizes[c];
+      queue.push_back(w);
+    }
+  }
+
+  // Modules that could not be reached by a cluster with room to spare
+  for (size_t v = 0; v != n; ++v) {
+    if (_cluster[v] != UNASSIGNED) continue;
+    size_t const c = std::min_element(sizes.begin(), sizes.end()) - sizes.begin();
+    _cluster[v] = c;
+    ++sizes[c];
+  }
+
+  // Allow the clusters to deviate 3% from the average size
+  size_t const average = n / k;
+  size_t const maxSize = average + average * 3 / 100 + 1;
+  size_t const minSize = average - average * 3 / 100;
+
+  static constexpr size_t MAX_PASSES = 16;
+  std::vector<size_t> links(k, 0);
+  for (size_t pass = 0; pass != MAX_PASSES; ++pass) {
+    size_t moves = 0;
+    for (size_t v = 0; v != n; ++v) {
+      for (int w: neighbours[v]) ++links[_cluster[w]];
+
+      size_t const own = _cluster[v];
+      size_t best = own;
+      for (int w: neighbours[v]) {
+	size_t const c = _cluster[w];
+	if (links[c] > links[best] && sizes[c] < maxSize) best = c;
+      }
+      for (int w: neighbours[v]) links[_cluster[w]] = 0;
+
+      if (best == own || sizes[own] <= minSize) continue;
+      _cluster[v] = best;
+      --sizes[own];
+      ++sizes[best];
+      ++moves;
+    }
+    if (moves == 0) break;
+  }
+
+  // A minimal cut can still have a ragged boundary that signals cross back and
+  // forth, and every crossing costs a round. Walking the schedule in order,
+  // each module joins the cluster that drives most of its inputs (the lowest
+  // numbered one on a tie), so that a signal path rarely crosses the same
+  // boundary twice. Modules without earlier drivers keep the cluster assigned
+  // above. This trades some balance for far fewer rounds.
+  std::vector<size_t> rank(n);
+  for (size_t r = 0; r != _worklist.schedule().size(); ++r) {
+    rank[_worklist.schedule()[r]] = r;
+  }
+  std::vector<std::vector<int>> drivers(n);
+  for (size_t v = 0; v != n; ++v) {
+    for (int w: _modules[v]->outgoingModules()) {
+      if (w >= 0 && rank[v] < rank[w]) drivers[w].push_back(v);
+    }
+  }
+  for (int v: _worklist.schedule()) {
+    if (drivers[v].empty()) continue;
+    for (int w: drivers[v]) ++links[_cluster[w]];
+
+    size_t const own = _cluster[v];
+    size_t best = own;
+    for (int w: drivers[v]) {
+      size_t const c = _cluster[w];
+      if (links[c] > links[best] || (links[c] == links[best] && c < best)) best = c;
+    }
+    for (int w: drivers[v]) links[_cluster[w]] = 0;
+
+    if (best == own) continue;
+    _cluster[v] = best;
+    --sizes[own];
+    ++sizes[best];
+  }
+
+  _partition.sizes = sizes;
+}
+
+inline void System::buildBoundary() {
+  // Redirect every input that is driven by a module of another cluster to a
+  // mirror of the driving output. The system reads the outputs directly,
+  // since it is only read once all clusters have settled.
+  std::vector<int> const &owner = _signalOwner;
+
+  auto const arenaIndex = [&](signal_t const *ptr) -> std::optional<size_t> {
+    if (ptr < _signals.data() || ptr >= _signals.data() + _signals.size()) return std::nullopt;
+    return ptr - _signals.data();
+  };
+
+  // Collect the readers in other clusters of every boundary output
+  std::vector<std::vector<int>> readers(_signals.size());
+  _partition.connections = 0;
+  _partition.cutConnections = 0;
+
+  for (size_t slot = this->nInputs(); slot != _slotReader.size(); ++slot) {
+    int const idx = _slotReader[slot];
+    for (Impl::Driver const &driver: _netlist.inputRow(slot)) {
+      std::optional<size_t> const signal = arenaIndex(driver.ptr);
+      if (!signal) continue;
+
+      ++_partition.connections;
+      if (_cluster[owner[*signal]] == _cluster[idx]) continue;
+
+      ++_partition.cutConnections;
+      if (std::find(readers[*signal].begin(), readers[*signal].end(), idx) == readers[*signal].end()) {
+	readers[*signal].push_back(idx);
+      }
+    }
+  }
+
+  std::vector<size_t> mirrorIndex(_signals.size(), -1);
+  _boundarySources.clear();
+  _boundaryReaders.clear();
+  _boundaryOffsets.assign(1, 0);
+  for (size_t signal = 0; signal != _signals.size(); ++signal) {
+    if (readers[signal].empty()) continue;
+    mirrorIndex[signal] = _boundarySources.size();
+    _boundarySources.push_back(&_signals[signal]);
+    _boundaryReaders.insert(_boundaryReaders.end(), readers[signal].begin(), readers[signal].end());
+    _boundaryOffsets.push_back(_boundaryReaders.size());
+  }
+  _partition.boundarySignals = _boundarySources.size();
+
+  _mirror.resize(_boundarySources.size());
+  for (size_t b = 0; b != _boundarySources.size(); ++b) {
+    _mirror[b] = *_boundarySources[b];
+  }
+
+  for (size_t slot = this->nInputs(); slot != _slotReader.size(); ++slot) {
+    int const idx = _slotReader[slot];
+    for (Impl::Driver &driver: _netlist.inputRow(slot)) {
+      std::optional<size_t> const signal = arenaIndex(driver.ptr);
+      if (signal && _cluster[owner[*signal]] != _cluster[idx]) {
+	driver.ptr = &_mirror[mirrorIndex[*signal]];
+      }
+    }
+  }
+
+  _clusterWorklists.resize(_nClusters);
+  for (Impl::Worklist &worklist: _clusterWorklists) {
+    worklist.resize(_worklist.schedule());
+  }
+  _clusterUpdates.assign(_nClusters, 0);
+}
+
+inline bool System::exchangeBoundary() {
+  bool changed = false;
+  for (size_t b = 0; b != _boundarySources.size(); ++b) {
+    signal_t const value = *_boundarySources[b];
+    if (value == _mirror[b]) continue;
+
+    _mirror[b] = value;
+    for (size_t r = _boundaryOffsets[b]; r != _boundaryOffsets[b + 1]; ++r) {
+      int const idx = _boundaryReaders[r];
+      _clusterWorklists[_cluster[idx]].push(idx);
+    }
+    changed = true;
+  }
+  return changed;
+}
+
+template <typename Update>
+void System::drainClusters(Update &&update) {
+  // Hand the pending modules to their clusters
+  _worklist.drain([&](int idx) {
+    _clusterWorklists[_cluster[idx]].push(idx);
+  });
+
+  auto task = [&](size_t worker) {
+    if (worker >= _nClusters) return;
+    Impl::Worklist &worklist = _clusterWorklists[worker];
+    size_t updates = 0;
+    worklist.drain([&](int idx) {
+      // Modules of other clusters are notified by exchangeBoundary()
+      if (_cluster[idx] != worker) return;
+      ++updates;
+      update(idx, worklist);
+    });
+    _clusterUpdates[worker] = updates;
+  };
+
+  do {
+    _pool->run(task);
+    ++_stats.rounds;
+    for (size_t updates: _clusterUpdates) {
+      _stats.updates += updates;
+    }
+  } while (exchangeBoundary());
+
+  // Collect the guarantees made in all clusters
+  for (Impl::Worklist &worklist: _clusterWorklists) {
+    _worklist.merge(worklist);
+  }
+}
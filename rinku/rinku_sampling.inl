@@ -0,0 +1,91 @@
+// Change-driven sampling. Scopes are sampled after every half step, but most
+// of the monitored signals keep their value from one sample to the next.
+// Instead of inspecting all of them, the system subscribes to the outputs that
+// are monitored: a module that gives such an output a new value while settling
+// reports it (see Module::updateAndCheckAs() and evaluateLogic()), and only the
+// signals reported since the last sample are inspected. This includes outputs
+// that were set from outside, even those of disabled modules, which are
+// reported on the next settle (see ModuleBase::outsideWrite()). Monitoring then costs
+// time in proportion to the activity of the monitored signals rather than to
+// their number. Signals that do not change through the settle loop are
+// inspected on every sample: signals outside the signal arena (the clock) and
+// the outputs of aliased wires, which are refreshed just before sampling. When
+// the system settles concurrently, modules would report from several threads
+// at once, so every signal is inspected on every sample instead.
+
+inline void System::buildWatchers() {
+  for (auto const &m: _modules) {
+    m->unwatchOutputs();
+  }
+
+  _logs.clear();
+  _polledLogs.clear();
+  _changedSignals.clear();
+  for (auto const &scope: _scopes) {
+    for (VcdScope::SignalLog &log: scope->_monitoredSignals) {
+      _logs.push_back(&log);
+    }
+  }
+
+  _watchChanges = (_settleThreads <= 1 && _nClusters <= 1);
+  _sampleAll = true;
+
+  std::vector<std::vector<size_t>> watchers(_signals.size());
+  for (size_t idx = 0; idx != _logs.size(); ++idx) {
+    signal_t const *ptr = _logs[idx]->ptr;
+    bool const inArena = (ptr >= _signals.data() && ptr < _signals.data() + _signals.size());
+    if (!inArena || _modules[_signalOwner[ptr - _signals.data()]]->aliased()) {
+      _polledLogs.push_back(idx);
+    }
+    else if (_watchChanges) {
+      watchers[ptr - _signals.data()].push_back(idx);
+    }
+  }
+
+  // The logs monitoring each signal are stored in one array, like the rows of
+  // the netlist
+  _watchers.clear();
+  _watcherOffsets.assign(1, 0);
+  for (size_t signal = 0; signal != _signals.size(); ++signal) {
+    _watchers.insert(_watchers.end(), watchers[signal].begin(), watchers[signal].end());
+    _watcherOffsets.push_back(_watchers.size());
+    if (!watchers[signal].empty()) {
+      _modules[_signalOwner[signal]]->watchOutput(_signals.data() + signal, &_changedSignals);
+    }
+  }
+
+  // Settling does not allocate once these have grown to their working size
+  _changedSignals.reserve(_signals.size());
+  _dirtyLogs.reserve(_logs.size());
+}
+
+inline void System::sampleScopes() {
+  if (_sampleAll || !_watchChanges) {
+    for (auto &scope: _scopes) {
+      scope->sample(_tickCount, _stream.get());
+    }
+    _stats.samples += _logs.size();
+    _changedSignals.clear();
+    _sampleAll = false;
+    return;
+  }
+
+  // A signal that changed more than once while settling is reported more than
+  // once. The logs are sampled in the order of their index, so the changes
+  // reach a stream in the same order as when all signals are sampled.
+  _dirtyLogs.assign(_polledLogs.begin(), _polledLogs.end());
+  for (signal_t const *ptr: _changedSignals) {
+    size_t const signal = ptr - _signals.data();
+    _dirtyLogs.insert(_dirtyLogs.end(),
+		      _watchers.begin() + _watcherOffsets[signal],
+		      _watchers.begin() + _watcherOffsets[signal + 1]);
+  }
+  _changedSignals.clear();
+
+  std::sort(_dirtyLogs.begin(), _dirtyLogs.end());
+  _dirtyLogs.erase(std::unique(_dirtyLogs.begin(), _dirtyLogs.end()), _dirtyLogs.end());
+  for (size_t idx: _dirtyLogs) {
+    VcdScope::sampleSignal(*_logs[idx], _tickCount, _stream.get());
+  }
+  _stats.samples += _dirtyLogs.size();
+}
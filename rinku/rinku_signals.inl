@@ -3,7 +3,7 @@ struct IO_ {
   static constexpr bool IsInput = isInput;
   static constexpr bool IsOutput = !isInput;
   static constexpr size_t Width = N;
-  static constexpr signal_t Mask = (N == 64 ? -1 : (1 << N) - 1);
+  static constexpr signal_t Mask = (N == 64 ? -1 : (signal_t(1) << N) - 1);
   using Base = Base_;
 };
     
@@ -76,7 +76,7 @@ signal_t const *Signals_<Args...>::masks() {
 };
 
 template <typename ... Args>
-size_t const *widths() {
+size_t const *Signals_<Args...>::widths() {
   static constexpr size_t const _widths[] = {
     (Args::Width)...
   };
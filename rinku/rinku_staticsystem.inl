@@ -0,0 +1,153 @@
+template <typename ... Modules>
+StaticSystem<Modules ...>::StaticSystem(double freq):
+  System(freq)
+{}
+
+template <typename ... Modules>
+template <typename ModuleT>
+ModuleT& StaticSystem<Modules ...>::addModule() {
+  return addModuleImpl<ModuleT>("");
+}
+
+template <typename ... Modules>
+template <typename ModuleT, typename First, typename ... Rest>
+ModuleT& StaticSystem<Modules ...>::addModule(First&& first, Rest&& ... rest) {
+  if constexpr (firstArgIsName<ModuleT, First, Rest ...>()) {
+    return addModuleImpl<ModuleT>(std::forward<First>(first),
+				  std::forward<Rest>(rest)...);
+  }
+  else {
+    return addModuleImpl<ModuleT>("",
+				  std::forward<First>(first),
+				  std::forward<Rest>(rest)...);
+  }
+}
+
+template <typename ... Modules>
+template <typename ModuleT, typename... Args>
+ModuleT& StaticSystem<Modules ...>::addModuleNamed(std::string const &name, Args&&... args) {
+  return addModuleImpl<ModuleT>(name, std::forward<Args>(args)...);
+}
+
+template <typename ... Modules>
+template <typename ModuleT, typename... Args>
+ModuleT& StaticSystem<Modules ...>::addModuleUnnamed(Args&&... args) {
+  return addModuleImpl<ModuleT>("", std::forward<Args>(args)...);
+}
+
+template <typename ... Modules>
+template <typename ModuleT, typename... Args>
+ModuleT& StaticSystem<Modules ...>::addModuleImpl(std::string const &name, Args&&... args) {
+  static_assert(std::is_base_of_v<Impl::ModuleBase, ModuleT>,
+		"Module-type must derive from Module<...>.");
+
+  // The module goes into the slot at the position of its module index
+  size_t const slot = moduleCount();
+  ModuleT *ptr = [&]<size_t ... I>(std::index_sequence<I ...>) {
+    ModuleT *result = nullptr;
+    (void)((slot == I && (result = emplace<I, ModuleT>(std::forward<Args>(args)...))) || ...);
+    return result;
+  }(std::make_index_sequence<N>{});
+
+  Error::throw_runtime_error_if
+    <Error::StaticModuleMismatch>(ptr == nullptr, slot, typeid(ModuleT).name());
+
+  // The module is owned by the static system, not by the pointer
+  return registerModule(std::shared_ptr<ModuleT>(std::shared_ptr<void>(), ptr), name);
+}
+
+template <typename ... Modules>
+template <size_t I, typename ModuleT, typename... Args>
+ModuleT *StaticSystem<Modules ...>::emplace(Args&& ... args) {
+  if constexpr (std::is_same_v<ModuleT, ModuleAt<I>>) {
+    return &std::get<I>(_slots).emplace(std::forward<Args>(args)...);
+  }
+  else {
+    return nullptr;
+  }
+}
+
+template <typename ... Modules>
+template <size_t I>
+typename StaticSystem<Modules ...>::template ModuleAt<I> &StaticSystem<Modules ...>::get() {
+  return *std::get<I>(_slots);
+}
+
+template <typename ... Modules>
+void StaticSystem<Modules ...>::init() {
+  Error::throw_runtime_error_if
+    <Error::StaticSystemIncomplete>(moduleCount() != N, moduleCount(), N);
+
+  System::init();
+}
+
+template <typename ... Modules>
+bool StaticSystem<Modules ...>::halfStep(bool resume) {
+  return System::halfStep(resume,
+			  [this](int idx, Impl::Worklist &worklist) { updateModule(idx, worklist); },
+			  [this] { riseAll(); },
+			  [this] { fallAll(); });
+}
+
+template <typename ... Modules>
+void StaticSystem<Modules ...>::updateModule(int idx, Impl::Worklist &worklist) {
+  // Compare the index against every slot at compile time. The compiler turns
+  // this into a switch with a direct call per slot, so that the update of each
+  // module type can be inlined into the settle loop.
+  [&]<size_t ... I>(std::index_sequence<I ...>) {
+    (void)((size_t(idx) == I && (updateSlot<I>(worklist), true)) || ...);
+  }(std::make_index_sequence<N>{});
+}
+
+template <typename ... Modules>
+void StaticSystem<Modules ...>::riseAll() {
+  if (parallelClock()) return riseParallel();
+  
+  setClock(1);
+  [this]<size_t ... I>(std::index_sequence<I ...>) {
+    (riseSlot<I>(), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+template <typename ... Modules>
+void StaticSystem<Modules ...>::fallAll() {
+  if (parallelClock()) return fallParallel();
+  
+  setClock(0);
+  [this]<size_t ... I>(std::index_sequence<I ...>) {
+    (fallSlot<I>(), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+template <typename ... Modules>
+template <size_t I>
+void StaticSystem<Modules ...>::updateSlot(Impl::Worklist &worklist) {
+  using ModuleT = ModuleAt<I>;
+  std::get<I>(_slots)->template updateAndCheckAs<ModuleT>(worklist);
+}
+
+template <typename ... Modules>
+template <size_t I>
+void StaticSystem<Modules ...>::riseSlot() {
+  using ModuleT = ModuleAt<I>;
+  if constexpr (!Impl::inheritsClockRising<ModuleT>) {
+    ModuleT &m = *std::get<I>(_slots);
+    m.allowSetOutput(false);
+    if constexpr (requires { m.ModuleT::clockRising(); }) m.ModuleT::clockRising();
+    else static_cast<Impl::ModuleBase &>(m).clockRising();
+    m.allowSetOutput(true);
+  }
+}
+
+template <typename ... Modules>
+template <size_t I>
+void StaticSystem<Modules ...>::fallSlot() {
+  using ModuleT = ModuleAt<I>;
+  if constexpr (!Impl::inheritsClockFalling<ModuleT>) {
+    ModuleT &m = *std::get<I>(_slots);
+    m.allowSetOutput(false);
+    if constexpr (requires { m.ModuleT::clockFalling(); }) m.ModuleT::clockFalling();
+    else static_cast<Impl::ModuleBase &>(m).clockFalling();
+    m.allowSetOutput(true);
+  }
+}
@@ -1,22 +1,82 @@
 
+inline void System::Clock_::set(signal_t value) {
+  _value = value;
+}
+
 inline void System::Clock_::rise() {
   _value = 1;
-  for (auto const &m: _attached) {
-    m->resetGuaranteed();
-    m->allowSetOutput(false);
-    m->clockRising();
-    m->allowSetOutput(true);
-  }
+  dispatch(_rising, _risingShared, _risingSerial, &Impl::ModuleBase::clockRising);
 }
 
 inline void System::Clock_::fall() {
   _value = 0;
-  for (auto const &m: _attached) {
-    m->resetGuaranteed();
+  dispatch(_falling, _fallingShared, _fallingSerial, &Impl::ModuleBase::clockFalling);
+}
+
+inline void System::Clock_::dispatch(std::vector<Impl::ModuleBase*> const &all,
+				     std::vector<Impl::ModuleBase*> const &shared,
+				     std::vector<Impl::ModuleBase*> const &serial,
+				     void (Impl::ModuleBase::*handler)()) {
+  auto const call = [handler](Impl::ModuleBase *m) {
     m->allowSetOutput(false);
-    m->clockFalling();
+    (m->*handler)();
     m->allowSetOutput(true);
+  };
+
+  if (!_pool || shared.size() < _minShared) {
+    for (Impl::ModuleBase *m: all) {
+      call(m);
+    }
+    return;
+  }
+
+  // Clock handlers only read inputs and change the state of their own module,
+  // so they can run concurrently. Modules that declared SERIAL_CLOCK() follow
+  // afterwards on the calling thread, in the order in which they were added.
+  size_t const chunk = std::max<size_t>(shared.size() / (4 * _workers), 1);
+  std::atomic<size_t> next = 0;
+  auto task = [&](size_t worker) {
+    if (worker >= _workers) return;
+    for (size_t first = next.fetch_add(chunk); first < shared.size(); first = next.fetch_add(chunk)) {
+      size_t const last = std::min(first + chunk, shared.size());
+      for (size_t idx = first; idx != last; ++idx) {
+	call(shared[idx]);
+      }
+    }
+  };
+
+  _worklist->share(true);
+  try {
+    _pool->run(task);
   }
+  catch (...) {
+    _worklist->share(false);
+    throw;
+  }
+  _worklist->share(false);
+
+  for (Impl::ModuleBase *m: serial) {
+    call(m);
+  }
+}
+
+inline bool System::Clock_::parallel() const {
+  return _pool != nullptr;
+}
+
+inline std::vector<bool> System::Clock_::handlers(size_t nModules) const {
+  // Indexed by module
+  std::vector<bool> result(nModules, false);
+  for (Impl::ModuleBase const *m: _rising) result[m->getModuleIndex()] = true;
+  for (Impl::ModuleBase const *m: _falling) result[m->getModuleIndex()] = true;
+  return result;
+}
+
+inline void System::Clock_::dispatchOn(Impl::ThreadPool *pool, size_t workers, Impl::Worklist *worklist, size_t minHandlers) {
+  _pool = pool;
+  _workers = workers;
+  _worklist = worklist;
+  _minShared = minHandlers;
 }
 
 inline signal_t const &System::Clock_::value() const {
@@ -25,7 +85,15 @@ inline signal_t const &System::Clock_::value() const {
 
 template <typename ModuleT>
 void System::Clock_::attach(std::shared_ptr<ModuleT> const &m) {
-  _attached.emplace_back(m);
+  constexpr bool serial = requires { requires ModuleT::SerialClock; };
+  if constexpr (!Impl::inheritsClockRising<ModuleT>) {
+    _rising.push_back(m.get());
+    (serial ? _risingSerial : _risingShared).push_back(m.get());
+  }
+  if constexpr (!Impl::inheritsClockFalling<ModuleT>) {
+    _falling.push_back(m.get());
+    (serial ? _fallingSerial : _fallingShared).push_back(m.get());
+  }
 }
 
 
@@ -65,7 +133,11 @@ ModuleT& System::addModuleImpl(std::string const &name, Args&&... args) {
   static_assert(std::is_base_of_v<Impl::ModuleBase, ModuleT>,
 		"Module-type must derive from Module<...>.");
 
-  auto ptr = std::make_shared<ModuleT>(std::forward<Args>(args)...);
+  return registerModule(std::make_shared<ModuleT>(std::forward<Args>(args)...), name);
+}
+
+template <typename ModuleT>
+ModuleT& System::registerModule(std::shared_ptr<ModuleT> const &ptr, std::string const &name) {
   Error::throw_runtime_error_if
     <Error::DuplicateModuleNames>(_moduleIndexByName.contains(name), name);
   
@@ -75,6 +147,17 @@ ModuleT& System::addModuleImpl(std::string const &name, Args&&... args) {
   
   _moduleIndexByName[ptr->name()] = _moduleCount;
   ptr->setModuleIndex(_moduleCount);
+  if constexpr (requires { requires ModuleT::EventDriven; }) {
+    ptr->setEventDriven(true);
+  }
+  if constexpr (requires { requires ModuleT::PureUpdate; }) {
+    // The outputs of a pure module only change when its inputs do
+    ptr->setPureUpdate(true);
+    ptr->setEventDriven(true);
+  }
+  if constexpr (requires { requires ModuleT::NoLookupTable; }) {
+    ptr->allowTable(false);
+  }
   _clk.attach(ptr);
   _modules.emplace_back(ptr);
   ++_moduleCount;
@@ -88,20 +171,30 @@ ModuleT& System::addModule() {
     
 template <typename ModuleT, typename First, typename ... Rest>
 ModuleT& System::addModule(First&& first, Rest&& ... rest) {
+  if constexpr (firstArgIsName<ModuleT, First, Rest ...>()) {
+    return addModuleImpl<ModuleT>(std::forward<First>(first),
+				  std::forward<Rest>(rest)...);
+  }
+  else {
+    return addModuleImpl<ModuleT>("",
+				  std::forward<First>(first),
+				  std::forward<Rest>(rest)...);
+  }
+}
+
+template <typename ModuleT, typename First, typename ... Rest>
+constexpr bool System::firstArgIsName() {
   if constexpr (std::is_convertible_v<First, std::string>) {
     if constexpr (!std::is_constructible_v<ModuleT, First, Rest ...>) {
       // First arg is a string and object cannot be built including that string -> string is name
-      return addModuleImpl<ModuleT>(std::forward<First>(first),
-				    std::forward<Rest>(rest)...);
+      return true;
     }
     else {
       // First arg is a string and object can be built including that string.
       // Check if it can be built without.
       if constexpr (!std::is_constructible_v<ModuleT, Rest ...>) {
 	// Can't be built without -> string is part of constructor -> unnamed
-	return addModuleImpl<ModuleT>("",
-				      std::forward<First>(first),
-				      std::forward<Rest>(rest) ...);
+	return false;
       }
       else {
 	// Ambiguous
@@ -114,13 +207,12 @@ ModuleT& System::addModule(First&& first, Rest&& ... rest) {
 		      "  • addModuleUnnamed<ModuleT>(…);   // force unnamed module\n"
 		      "  • addModuleNamed<ModuleT>(name, …); // force named module\n"
 		      );
+	return false;
       }
     }
   }
   else {
-    return addModuleImpl<ModuleT>("",
-				  std::forward<First>(first),
-				  std::forward<Rest>(rest)...);
+    return false;
   }
 }
 
@@ -177,45 +269,319 @@ void System::connectExitCode(Module_ &m) {
 }
 
 inline void System::updateAll() {
-  static std::vector<int> q;
-  static std::vector<bool> inQ(_moduleCount);
-
-  // Populate the queue with all modules
-  q.resize(_moduleCount);
-  std::iota(q.begin(), q.end(), 0);
-  std::fill(inQ.begin(), inQ.end(), true);
-
-  // Update and follow the affected modules until system has settled
-  size_t qHead = 0;
-  while (qHead < q.size()) {
-    int idx = q[qHead++];
-    inQ[idx] = false;
-
-    std::vector<int> affectedIndices = _modules[idx]->updateAndCheck();
-    for (int outIdx: affectedIndices) {
-      if (outIdx < 0 || inQ[outIdx]) continue;
-      q.push_back(outIdx);
-      inQ[outIdx] = true;
+  checkIfInitialized();
+
+  // Pure modules are updated even if their inputs did not change, so that
+  // outputs that were set from outside are recomputed
+  for (auto const &m: _modules) {
+    m->forgetInputs();
+  }
+  _worklist.pushAll();
+  drainWorklist([this](int idx, Impl::Worklist &worklist) {
+    _modules[idx]->updateAndCheck(worklist);
+  });
+}
+
+inline void System::enableParallelSettle(size_t threads, size_t minLevelSize) {
+  _settleThreads = std::max<size_t>(threads, 1);
+  _minParallelLevel = minLevelSize;
+  resizePool();
+
+  if (_initialized) {
+    // Regroup the schedule by level. Pending updates are lost in the process,
+    // so all modules are updated on the next settle. Concurrent settling
+    // does not report the changes of monitored outputs.
+    buildWatchers();
+    buildSchedule();
+    _worklist.pushAll();
+  }
+}
+
+inline void System::reconfigure() {
+  // Modules were enabled or disabled after init(), for example by the
+  // debugger's poke. A disabled gate keeps its output and must therefore not
+  // be evaluated as part of a fused logic block; a gate that was enabled
+  // again can rejoin one. Wires that were disabled or whose outputs were set
+  // from outside are no longer aliased (see ModuleBase::unalias()): they are
+  // kept in place from now on, and their readers read their outputs again.
+  // Likewise, the modules frozen along with a pure module that was disabled
+  // or set from outside no longer have constant inputs, and may be frozen
+  // again once it is enabled.
+  bool rewire = false;
+  bool refreeze = false;
+  for (int idx: _reconfigured) {
+    refreeze = refreeze || _modules[idx]->pureUpdate();
+    if (!_aliasedWires[idx] || _modules[idx]->aliased() || _keptWires[idx]) continue;
+    _keptWires[idx] = true;
+    if (!_modules[idx]->eventDriven()) _alwaysUpdated.push_back(idx);
+    rewire = true;
+  }
+  _reconfigured.clear();
+
+  if (rewire) {
+    _netlist = _wiredNetlist;
+    aliasWires();
+    if (_nClusters > 1) buildBoundary();
+    this->bindNetlist(_netlist);
+    for (auto const &m: _modules) {
+      m->bindNetlist(_netlist);
+    }
+  }
+
+  if (refreeze) {
+    // Every pure module is updated once, frozen or not, so that the modules
+    // reading a module that was set from outside see its outputs
+    freezeConstants();
+    for (auto const &m: _modules) {
+      m->forgetInputs();
     }
   }
+
+  if (rewire) {
+    // The wires are back in the graph, between their drivers and readers
+    buildWatchers();
+    buildSchedule();
+  }
+  else {
+    buildLogicBlocks();
+  }
+
+  // Pending updates are lost when the schedule is rebuilt, so all modules are
+  // updated
+  if (rewire || refreeze) _worklist.pushAll();
+}
+
+inline void System::enableParallelClock(size_t threads, size_t minHandlers) {
+  _clockThreads = std::max<size_t>(threads, 1);
+  _minParallelClock = minHandlers;
+  resizePool();
+}
+
+inline void System::resizePool() {
+  // One pool serves settling, clock dispatch and partitioned settling, each of
+  // which uses as many of its threads as it was given.
+  size_t const threads = std::max({_settleThreads, _clockThreads, _nClusters});
+  if (threads <= 1) {
+    _pool.reset();
+  }
+  else if (!_pool || _pool->size() != threads) {
+    _pool = std::make_unique<Impl::ThreadPool>(threads);
+  }
+
+  _localWorklists.resize(_pool ? _pool->size() - 1 : 0);
+  for (Impl::Worklist &local: _localWorklists) {
+    local.resize(_worklist.schedule());
+  }
+  _clk.dispatchOn(_clockThreads > 1 ? _pool.get() : nullptr, _clockThreads, &_worklist, _minParallelClock);
+}
+
+template <typename Update>
+void System::settle(Update &&update) {
+  // Event-driven modules have been put on the worklist by their clock handlers
+  // (through stateChanged()) or by the modules driving their inputs. All other
+  // modules are updated on every settle.
+  if (_alwaysUpdated.size() == _moduleCount) {
+    _worklist.pushAll();
+  }
+  else for (int idx: _alwaysUpdated) {
+    _worklist.push(idx);
+  }
+  drainWorklist(update);
+}
+
+template <typename Update>
+void System::drainWorklist(Update &&update) {
+  if (!_reconfigured.empty()) reconfigure();
+
+  // Update modules in schedule order until the system has settled
+  if (_nClusters > 1) {
+    drainClusters(update);
+  }
+  else if (_settleThreads > 1) {
+    drainLevels(update);
+  }
+  else if (!_logicOps.empty()) {
+    _worklist.drain([&](int idx) {
+      ++_stats.updates;
+      int const position = _logicPosition[idx];
+      if (position < 0) update(idx, _worklist);
+      else evaluateLogic(position);
+    });
+  }
+  else {
+    _worklist.drain([&](int idx) {
+      ++_stats.updates;
+      update(idx, _worklist);
+    });
+  }
+  ++_stats.settles;
 }
+
+template <typename Update>
+void System::drainLevels(Update &&update) {
+  // The schedule is grouped by level: a module only depends on modules in
+  // lower levels, unless it is part of a loop. The lowest pending level is
+  // evaluated as a whole until nothing is pending anymore. The modules of a
+  // level without loops do not read each other's outputs, so they can be
+  // updated concurrently and in any order without affecting the result. Every
+  // worker pushes the modules it affects onto a worklist of its own; these are
+  // merged once the level is done.
+  size_t const n = _worklist.schedule().size();
+  for (size_t rank = _worklist.lowestPending(); rank != n; rank = _worklist.lowestPending()) {
+    size_t const level = std::upper_bound(_levelStarts.begin(), _levelStarts.end(), rank) - _levelStarts.begin() - 1;
+    size_t const end = _levelStarts[level + 1];
+
+    if (_levelCyclic[level]) {
+      // Loops are settled one module at a time, as in serial mode
+      for (; rank < end; rank = _worklist.lowestPending()) {
+	_batch.clear();
+	_worklist.take(rank, rank + 1, _batch);
+	++_stats.updates;
+	update(_batch[0], _worklist);
+      }
+      continue;
+    }
+
+    _batch.clear();
+    _worklist.take(_levelStarts[level], end, _batch);
+    _stats.updates += _batch.size();
     
+    if (_batch.size() < _minParallelLevel) {
+      for (int idx: _batch) {
+	update(idx, _worklist);
+      }
+      continue;
+    }
+
+    // Hand out the modules in chunks, so that workers that finish early can
+    // take over from the others.
+    size_t const chunk = std::max<size_t>(_batch.size() / (4 * _settleThreads), 1);
+    std::atomic<size_t> next = 0;
+    auto task = [&](size_t worker) {
+      if (worker >= _settleThreads) return;
+      Impl::Worklist &worklist = (worker == 0) ? _worklist : _localWorklists[worker - 1];
+      for (size_t first = next.fetch_add(chunk); first < _batch.size(); first = next.fetch_add(chunk)) {
+	size_t const last = std::min(first + chunk, _batch.size());
+	for (size_t idx = first; idx != last; ++idx) {
+	  update(_batch[idx], worklist);
+	}
+      }
+    };
+    _pool->run(task);
+
+    for (Impl::Worklist &local: _localWorklists) {
+      _worklist.merge(local);
+    }
+    ++_stats.parallelLevels;
+  }
+}
+
+inline void System::tabulatePureModules(size_t maxInputBits) {
+  _maxTableBits = maxInputBits;
+  if (_initialized) buildTables();
+}
+
+inline void System::buildTables() {
+  // Pure modules with few enough input bits are updated by table lookup,
+  // unless they declared NO_LOOKUP_TABLE()
+  _stats.tabulatedModules = 0;
+  for (auto const &m: _modules) {
+    if (m->pureUpdate() && m->tableAllowed() && m->tabulate(_maxTableBits)) ++_stats.tabulatedModules;
+  }
+}
+
+inline void System::freezeConstants() {
+  // A pure module that only reads constants and the outputs of frozen modules
+  // keeps the outputs it settled to in reset() forever. It is frozen, so that
+  // it is no longer updated; since its outputs never change, it is not pushed
+  // onto the worklist either. Modules with clock handlers, modules in a loop,
+  // disabled modules and modules that read signals from outside the arena
+  // (such as the clock) are left alone. Called again by reconfigure() when a
+  // pure module is disabled, enabled or set from outside.
+  auto const frozenDriver = [&](Impl::Driver const &driver) {
+    if (driver.ptr < _signals.data() || driver.ptr >= _signals.data() + _signals.size()) return false;
+    return _modules[_signalOwner[driver.ptr - _signals.data()]]->frozen();
+  };
+
+  for (auto const &m: _modules) {
+    m->unfreeze();
+  }
+  
+  _stats.frozenModules = 0;
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (int idx: _worklist.schedule()) {
+      Impl::ModuleBase &m = *_modules[idx];
+      if (m.frozen() || !m.pureUpdate() || !m.updateEnabled() || _inLoop[idx] || _clocked[idx]) continue;
+
+      bool constant = true;
+      for (size_t input = 0; input != m.nInputs() && constant; ++input) {
+	std::span<Impl::Driver> const row = _netlist.inputRow(_firstInputSlot[idx] + input);
+	constant = std::all_of(row.begin(), row.end(), frozenDriver);
+      }
+      if (!constant) continue;
+
+      m.freeze();
+      ++_stats.frozenModules;
+      changed = true;
+    }
+  }
+}
+
+inline System::Statistics const &System::statistics() const {
+  return _stats;
+}
+
+inline void System::resetStatistics() {
+  _stats.settles = 0;
+  _stats.updates = 0;
+  _stats.parallelLevels = 0;
+  _stats.rounds = 0;
+  _stats.samples = 0;
+}
+
+inline std::span<signal_t const> System::signals() const {
+  return _signals;
+}
+
 inline void System::reset() {
   _tickCount = 0;
+  releaseGuarantees();
   for (auto const &m: _modules) {
     m->reset();
     m->resetGuaranteed();
   }
+  _sampleAll = true;
   updateAll();
 }
 
 inline void System::init() {
   this->lock();
+  _alwaysUpdated.clear();
   for (auto const &m: _modules) {
     m->lock();
+    m->setWorklist(&_worklist);
+    m->setReconfigurationLog(&_reconfigured);
+    if (!m->eventDriven()) _alwaysUpdated.push_back(m->getModuleIndex());
   }
-  reset();
+  _clocked = _clk.handlers(_moduleCount);
+  buildSchedule();
+  auto const moved = buildSignalArena();
+  size_t code = 0;
+  for (auto const &scope: _scopes) {
+    scope->relocate(moved);
+    code = scope->assignCodes(code);
+  }
+  buildNetlist(moved);
+  buildTables();
+  buildWatchers();
+
   _initialized = true;
+  reset();
+  freezeConstants();
+
+  // Modules have now had the chance to guarantee not to read their inputs
+  buildSchedule();
 }
     
 inline signal_t System::run(bool resume) {
@@ -224,9 +590,17 @@ inline signal_t System::run(bool resume) {
 }
 
 inline bool System::halfStep(bool resume) {
+  return halfStep(resume,
+		  [this](int idx, Impl::Worklist &worklist) { _modules[idx]->updateAndCheck(worklist); },
+		  [this] { _clk.rise(); },
+		  [this] { _clk.fall(); });
+}
+
+template <typename Update, typename Rise, typename Fall>
+bool System::halfStep(bool resume, Update &&update, Rise &&rise, Fall &&fall) {
   checkIfInitialized();
 
-  updateAll();
+  settle(update);
   if ((_tickCount & 1) == 0) {
     if (getInput<SYS_EXIT>()) {
       return false;
@@ -240,17 +614,18 @@ inline bool System::halfStep(bool resume) {
       std::cerr << "\nSystem halted, press any key to resume ...";
       std::getchar();
     }
-    _clk.rise();
+    releaseGuarantees();
+    rise();
   }
   else {
-    _clk.fall();
+    releaseGuarantees();
+    fall();
   }
 
-  updateAll();
+  settle(update);
 
-  for (auto &scope: _scopes) {
-    scope->sample(_tickCount);
-  }
+  refreshWires();
+  sampleScopes();
 
   ++_tickCount;
   return true;
@@ -262,12 +637,12 @@ inline bool System::step(bool resume) {
 }
     
 template <typename ... Scopes>
-std::string System::vcd(Scopes const & ... args) {
+std::vector<VcdScope const *> System::selectScopes(Scopes const & ... args) {
 
   std::vector<VcdScope const *> scopeVec;
   if constexpr (sizeof ...(Scopes) > 0) {
     static_assert(( ... && (std::is_same_v<std::decay_t<Scopes>, VcdScope> || std::is_convertible_v<std::decay_t<Scopes>, std::string>)),
-		  "System::vcd() must be called with either VcdScope objects or strings (names).");
+		  "System::vcd() and System::waveform() must be called with either VcdScope objects or strings (names).");
 	
     scopeVec = {
       [&]<typename T>(T const &scopeVar) -> VcdScope const * {
@@ -282,47 +657,154 @@ std::string System::vcd(Scopes const & ... args) {
       scopeVec.push_back(ptr.get());
     }
   }
-      
-  auto const getTimescale = [](double f) -> std::string {
-    static constexpr char const *values[] = { "100", "10", "1" };
-    static constexpr char const *units[] = { "s", "ms", "us" ,"ns", "ps" };
-    int const power = std::round(std::log10(2 * f)) + 2;
-    return (std::string(values[power % 3]) + std::string(units[ power / 3]));
-  };
 
+  return scopeVec;
+}
+
+// The history of every signal is in order of time already, so the histories
+// are merged through a heap holding the next change of each signal. Changes at
+// the same time are emitted in the order in which the signals are monitored.
+template <typename Emit>
+void System::mergeHistories(std::vector<VcdScope::SignalLog const *> const &logs, Emit &&emit) {
+  using Next = std::pair<size_t, size_t>;  // time, index into logs
+  std::priority_queue<Next, std::vector<Next>, std::greater<Next>> heap;
+  std::vector<size_t> position(logs.size(), 0);
+  for (size_t idx = 0; idx != logs.size(); ++idx) {
+    if (!logs[idx]->history.empty()) heap.push({logs[idx]->history.front().first, idx});
+  }
+  
+  while (!heap.empty()) {
+    auto const [time, idx] = heap.top();
+    heap.pop();
+
+    VcdScope::SignalLog const &log = *logs[idx];
+    emit(time, idx, log.history[position[idx]].second);
+
+    if (++position[idx] != log.history.size()) {
+      heap.push({log.history[position[idx]].first, idx});
+    }
+  }
+}
+    
+template <typename ... Scopes>
+std::string System::vcd(Scopes const & ... args) {
+  std::vector<VcdScope const *> const scopeVec = selectScopes(args ...);
+      
   // Emit header
-  std::ostringstream out;
-  auto now = std::chrono::system_clock::now();
-  auto zoned = std::chrono::zoned_time(std::chrono::current_zone(), now);
-  std::string currentDateStr = std::format("{:%Y-%m-%d %H:%M}", zoned);      
-  out << "$date " << currentDateStr << " $end\n";
-  out << "$version Rinku VCD Dump $end\n";
-  out << "$timescale " << getTimescale(_scopeFreq) << " $end\n\n";
+  Impl::VcdEncoder out;
+  out.write(vcdHeader());
 
-  // Emit definitions for all scopes and collect events
-  std::vector<VcdScope::VCD::Event> events;
+  // Emit definitions for all scopes
+  std::vector<VcdScope::SignalLog const *> logs;
   for (VcdScope const *scope: scopeVec) {
-    VcdScope::VCD currentVcd = scope->vcd();
-    out << currentVcd.definitions;
-    events.insert(events.end(), currentVcd.events.begin(), currentVcd.events.end());
+    out.write(scope->definitions());
+    for (VcdScope::SignalLog const &log: scope->_monitoredSignals) {
+      logs.push_back(&log);
+    }
   }
-  std::sort(events.begin(), events.end(), [](auto const &a, auto const &b) {
-    return a.time < b.time;
-  });
 
   // Emit value changes
-  size_t currentTime = -1;
-  for (auto const &event: events) {
-    if (event.time != currentTime) {
-      currentTime = event.time;
-      out << '#' << currentTime << "\n";
+  mergeHistories(logs, [&](size_t time, size_t idx, signal_t value) {
+    out.change(time, logs[idx]->id, value, logs[idx]->width);
+  });
+      
+  return out.take();
+};
+
+// Same as vcd(), in the Rinku waveform format
+template <typename ... Scopes>
+std::string System::waveform(Scopes const & ... args) {
+  std::vector<VcdScope const *> const scopeVec = selectScopes(args ...);
+
+  std::vector<VcdScope::SignalLog const *> logs;
+  for (VcdScope const *scope: scopeVec) {
+    for (VcdScope::SignalLog const &log: scope->_monitoredSignals) {
+      logs.push_back(&log);
     }
-    std::string bits = std::bitset<64>(event.value).to_string();
-    out << 'b' << bits.substr(bits.length() - event.width) << ' ' << event.id << '\n';
   }
-      
+
+  std::ostringstream out;
+  Impl::WaveWriter writer(out, timescale(), waveformSignals(scopeVec), 1 << 18);
+  mergeHistories(logs, [&](size_t time, size_t idx, signal_t value) {
+    writer.change(time, idx, value);
+  });
+  writer.finish();
+
   return out.str();
-};
+}
+
+// Instead of keeping the history of every monitored signal in memory until
+// vcd() is called, the value changes are written to a file while the system
+// runs. The header and the definitions of all scopes are written right away,
+// followed by the current value of every signal.
+inline void System::streamVcd(std::string const &filename, size_t bufferSize) {
+  checkIfInitialized();
+
+  std::vector<std::string> codes;
+  std::vector<size_t> widths;
+  for (auto const &scope: _scopes) {
+    for (VcdScope::SignalLog const &log: scope->_monitoredSignals) {
+      codes.push_back(log.id);
+      widths.push_back(log.width);
+    }
+  }
+
+  _stream.reset();
+  auto stream = std::make_unique<Impl::VcdStream>(filename, bufferSize, codes, widths);
+  stream->write(vcdHeader());
+  for (auto const &scope: _scopes) {
+    stream->write(scope->definitions());
+    scope->restartSampling();
+  }
+  _stream = std::move(stream);
+  _sampleAll = true;
+}
+
+// Same as streamVcd(), in the Rinku waveform format. The blocks are written
+// when they reach the given (uncompressed) size, the index of the blocks when
+// the system is destroyed or another stream is started.
+inline void System::streamWaveform(std::string const &filename, size_t blockSize) {
+  checkIfInitialized();
+
+  std::vector<VcdScope const *> scopeVec;
+  for (auto const &scope: _scopes) {
+    scopeVec.push_back(scope.get());
+    scope->restartSampling();
+  }
+
+  _stream.reset();
+  _stream = std::make_unique<Impl::WaveStream>(filename, timescale(), waveformSignals(scopeVec), blockSize);
+  _sampleAll = true;
+}
+
+inline std::vector<Waveform::Signal> System::waveformSignals(std::vector<VcdScope const *> const &scopes) const {
+  std::vector<Waveform::Signal> signals;
+  for (VcdScope const *scope: scopes) {
+    for (VcdScope::SignalLog const &log: scope->_monitoredSignals) {
+      signals.push_back({scope->name(), VcdScope::reference(log), log.width});
+    }
+  }
+  return signals;
+}
+
+inline std::string System::timescale() const {
+  static constexpr char const *values[] = { "100", "10", "1" };
+  static constexpr char const *units[] = { "s", "ms", "us" ,"ns", "ps" };
+  int const power = std::round(std::log10(2 * _scopeFreq)) + 2;
+  return (std::string(values[power % 3]) + std::string(units[ power / 3]));
+}
+
+inline std::string System::vcdHeader() const {
+
+  std::ostringstream out;
+  auto now = std::chrono::system_clock::now();
+  auto zoned = std::chrono::zoned_time(std::chrono::current_zone(), now);
+  std::string currentDateStr = std::format("{:%Y-%m-%d %H:%M}", zoned);      
+  out << "$date " << currentDateStr << " $end\n";
+  out << "$version Rinku VCD Dump $end\n";
+  out << "$timescale " << timescale() << " $end\n\n";
+  return out.str();
+}
 
 
 template <typename S, typename ModuleType>
@@ -340,7 +822,27 @@ signal_t const *System::getOutputSignalPointer(ModuleType const &mod, size_t ind
     <Error::IndexOutOfBounds>(index >= ModuleType::Outputs::N,
 			      "output", mod.ModuleBase::name(), index, ModuleType::Outputs::N);
       
-  return &mod.outputState[index];
+  return &mod.outputs[index];
+}
+
+inline void System::setClock(signal_t value) {
+  _clk.set(value);
+}
+
+inline bool System::parallelClock() const {
+  return _clk.parallel();
+}
+
+inline void System::riseParallel() {
+  _clk.rise();
+}
+
+inline void System::fallParallel() {
+  _clk.fall();
+}
+
+inline size_t System::moduleCount() const {
+  return _moduleCount;
 }
 
 inline signal_t const *System::getClockSignalPointer() const {
@@ -351,6 +853,218 @@ inline void System::checkIfInitialized() {
   if (!_initialized) Error::throw_runtime_error<Error::SystemNotInitialized>();
 }
 
+inline void System::buildSchedule() {
+  // Modules that have guaranteed not to read their inputs do not depend on the
+  // modules driving them, so these connections are left out of the graph. The
+  // schedule only determines the order of evaluation; the system still settles
+  // correctly when a module turns out to depend on a module scheduled after it.
+  // Guarantees are released at every clock edge, however, so a module may read
+  // its inputs again later on. When levels are settled concurrently, such a
+  // module must not share a level with its drivers, and all connections are
+  // kept.
+  size_t const n = _moduleCount;
+  bool const concurrent = (_settleThreads > 1);
+  std::vector<std::vector<int>> successors(n);
+  for (size_t idx = 0; idx != n; ++idx) {
+    for (int next: _modules[idx]->outgoingModules()) {
+      if (next >= 0 && (concurrent || !_modules[next]->guaranteed())) successors[idx].push_back(next);
+    }
+  }
+
+  // Find the strongly connected components (combinational loops) using an
+  // iterative version of Tarjan's algorithm.
+  std::vector<int> order(n, -1);
+  std::vector<int> low(n, 0);
+  std::vector<int> component(n, -1);
+  std::vector<bool> onStack(n, false);
+  std::vector<int> stack;
+  std::vector<std::pair<int, size_t>> callStack;
+  int counter = 0;
+  int nComponents = 0;
+
+  auto const visit = [&](int v) {
+    order[v] = low[v] = counter++;
+    stack.push_back(v);
+    onStack[v] = true;
+    callStack.emplace_back(v, 0);
+  };
+  
+  for (size_t root = 0; root != n; ++root) {
+    if (order[root] != -1) continue;
+    visit(root);
+    
+    while (!callStack.empty()) {
+      int const v = callStack.back().first;
+      size_t const next = callStack.back().second++;
+
+      if (next < successors[v].size()) {
+	int const w = successors[v][next];
+	if (order[w] == -1) visit(w);
+	else if (onStack[w]) low[v] = std::min(low[v], order[w]);
+	continue;
+      }
+
+      if (low[v] == order[v]) {
+	int w;
+	do {
+	  w = stack.back();
+	  stack.pop_back();
+	  onStack[w] = false;
+	  component[w] = nComponents;
+	} while (w != v);
+	++nComponents;
+      }
+
+      callStack.pop_back();
+      if (!callStack.empty()) {
+	int const parent = callStack.back().first;
+	low[parent] = std::min(low[parent], low[v]);
+      }
+    }
+  }
+
+  // Order the components topologically. Among the components that are ready,
+  // the one containing the module that was added first goes first, so the
+  // schedule follows the order in which the system was built where possible.
+  std::vector<std::vector<int>> members(nComponents);
+  for (size_t idx = 0; idx != n; ++idx) {
+    members[component[idx]].push_back(idx);
+  }
+
+  std::vector<size_t> inDegree(nComponents, 0);
+  for (size_t v = 0; v != n; ++v) {
+    for (int w: successors[v]) {
+      if (component[w] != component[v]) ++inDegree[component[w]];
+    }
+  }
+
+  using Entry = std::pair<int, int>; // (first module, component)
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> ready;
+  for (int c = 0; c != nComponents; ++c) {
+    if (inDegree[c] == 0) ready.emplace(members[c][0], c);
+  }
+
+  std::vector<int> schedule;
+  std::vector<size_t> depth(nComponents, 0);
+  std::vector<bool> cyclic(nComponents, false);
+  size_t nLevels = 0;
+  _stats.cyclicModules = 0;
+  _inLoop.assign(n, false);
+  
+  while (!ready.empty()) {
+    int const c = ready.top().second;
+    ready.pop();
+
+    int const first = members[c][0];
+    cyclic[c] = (members[c].size() > 1) ||
+      std::find(successors[first].begin(), successors[first].end(), first) != successors[first].end();
+    if (cyclic[c]) _stats.cyclicModules += members[c].size();
+    for (int v: members[c]) _inLoop[v] = cyclic[c];
+
+    nLevels = std::max(nLevels, depth[c] + 1);
+    for (int v: members[c]) {
+      schedule.push_back(v);
+      for (int w: successors[v]) {
+	int const next = component[w];
+	if (next == c) continue;
+	depth[next] = std::max(depth[next], depth[c] + 1);
+	if (--inDegree[next] == 0) ready.emplace(members[next][0], next);
+      }
+    }
+  }
+  assert(schedule.size() == n && "schedule does not contain all modules");
+
+  if (_settleThreads > 1) {
+    // Group the modules by level for parallel settling. Sorting by level keeps
+    // the schedule in topological order and the members of a loop together.
+    auto const levelOf = [&](int v) { return depth[component[v]]; };
+    std::stable_sort(schedule.begin(), schedule.end(), [&](int a, int b) {
+      return levelOf(a) < levelOf(b);
+    });
+
+    _levelStarts.assign(nLevels + 1, 0);
+    _levelCyclic.assign(nLevels, false);
+    for (int v: schedule) {
+      ++_levelStarts[levelOf(v) + 1];
+      if (cyclic[component[v]]) _levelCyclic[levelOf(v)] = true;
+    }
+    std::partial_sum(_levelStarts.begin(), _levelStarts.end(), _levelStarts.begin());
+  }
+  
+  _worklist.resize(schedule);
+  for (Impl::Worklist &local: _localWorklists) {
+    local.resize(schedule);
+  }
+  for (Impl::Worklist &local: _clusterWorklists) {
+    local.resize(schedule);
+  }
+  _stats.levels = nLevels;
+
+  // Logic blocks are evaluated in schedule order, and can only be built once
+  // the netlist is in place
+  if (_initialized) buildLogicBlocks();
+}
+
+inline void System::releaseGuarantees() {
+  // A guarantee not to read inputs holds until the next clock edge
+  _worklist.releaseGuarantees([&](int idx) {
+    _modules[idx]->resetGuaranteed();
+  });
+}
+
+inline std::unordered_map<signal_t const*, signal_t const*> System::buildSignalArena() {
+  // Move the outputs of all modules into one contiguous array, in the order in
+  // which the modules are evaluated. Returns where each output was moved to, so
+  // that pointers to the old locations can be updated.
+  size_t total = 0;
+  for (auto const &m: _modules) {
+    total += m->nOutputs();
+  }
+
+  std::vector<signal_t> signals(total);
+  std::unordered_map<signal_t const*, signal_t const*> moved;
+  _signalOwner.assign(total, -1);
+  _firstSignal.assign(_moduleCount, 0);
+  size_t offset = 0;
+  for (int idx: _worklist.schedule()) {
+    _modules[idx]->moveOutputs(signals.data() + offset, moved);
+    _firstSignal[idx] = offset;
+    std::fill_n(_signalOwner.begin() + offset, _modules[idx]->nOutputs(), idx);
+    offset += _modules[idx]->nOutputs();
+  }
+  
+  _signals.swap(signals);
+  return moved;
+}
+
+inline void System::buildNetlist(std::unordered_map<signal_t const*, signal_t const*> const &moved) {
+  // Freeze all connections into the netlist, in the order in which the modules
+  // are evaluated, and let the modules point into it.
+  // The inputs of the system itself come first.
+  _netlist.clear();
+  this->addToNetlist(_netlist);
+  _slotReader.assign(this->nInputs(), this->getModuleIndex());
+  _firstInputSlot.assign(_moduleCount, 0);
+  for (int idx: _worklist.schedule()) {
+    _modules[idx]->addToNetlist(_netlist);
+    _firstInputSlot[idx] = _slotReader.size();
+    _slotReader.insert(_slotReader.end(), _modules[idx]->nInputs(), idx);
+  }
+  _netlist.relocate(moved);
+  _wiredNetlist = _netlist;
+  _keptWires.assign(_moduleCount, false);
+  aliasWires();
+  if (_nClusters > 1) {
+    partitionModules();
+    buildBoundary();
+  }
+  
+  this->bindNetlist(_netlist);
+  for (auto const &m: _modules) {
+    m->bindNetlist(_netlist);
+  }
+}
+
 inline std::string System::dot() const {
   std::ostringstream oss;
 
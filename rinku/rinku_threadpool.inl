@@ -0,0 +1,74 @@
+// The pool is used to evaluate the modules of a single level of the schedule,
+// so run() is called many times per clock cycle. The threads are started once
+// and wait for the next task in between runs. An exception thrown by the task
+// on any of the workers is rethrown by run() once all workers have finished.
+
+inline ThreadPool::ThreadPool(size_t nWorkers) {
+  for (size_t worker = 1; worker < nWorkers; ++worker) {
+    _threads.emplace_back([this, worker] { work(worker); });
+  }
+}
+
+inline ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _wake.notify_all();
+  for (std::thread &thread: _threads) {
+    thread.join();
+  }
+}
+
+inline size_t ThreadPool::size() const {
+  return _threads.size() + 1;
+}
+
+template <typename Task>
+void ThreadPool::run(Task &task) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _call = [](void *ptr, size_t worker) { (*static_cast<Task *>(ptr))(worker); };
+    _task = &task;
+    _busy = _threads.size();
+    ++_generation;
+  }
+  _wake.notify_all();
+
+  std::exception_ptr error;
+  try {
+    task(0);
+  }
+  catch (...) {
+    error = std::current_exception();
+  }
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _done.wait(lock, [this] { return _busy == 0; });
+  if (!error) error = _error;
+  _error = nullptr;
+  if (error) std::rethrow_exception(error);
+}
+
+inline void ThreadPool::work(size_t worker) {
+  size_t generation = 0;
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _wake.wait(lock, [&] { return _stop || _generation != generation; });
+    if (_stop) return;
+    generation = _generation;
+
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      _call(_task, worker);
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+
+    if (error && !_error) _error = error;
+    if (--_busy == 0) _done.notify_one();
+  }
+}
@@ -9,65 +9,106 @@ inline std::string const &VcdScope::name() const {
 }
 
 
-inline void VcdScope::sample(size_t time) {
+inline void VcdScope::sample(size_t time, Impl::TraceStream *stream) {
   for (SignalLog &log: _monitoredSignals) {
-    if (log.history.empty() || *log.ptr != log.history.back().second) {
-      log.history.push_back({time, *log.ptr & log.mask});
-    }
+    sampleSignal(log, time, stream);
   }
 }
 
-inline VcdScope::VCD VcdScope::vcd() const {
-  static auto const numberOfBits = [](signal_t mask) -> size_t {
-    size_t result = 0;
-    while (mask) {
-      ++result;
-      mask >>= 1;
-    }
-    return result;
-  };
+inline void VcdScope::sampleSignal(SignalLog &log, size_t time, Impl::TraceStream *stream) {
+  signal_t const value = *log.ptr & log.mask;
+  if (log.sampled && value == log.last) return;
 
-  auto const toId = [&](std::string const &modName, std::string const &signalName) -> std::string {
-    std::string result;
-    for (char c: modName) {
-      if (std::isspace(c) || c == '$' || c == '#') continue;
-      result += std::tolower(c);
-    }
-    result += '_';
-    for (char c: signalName) {
-      if (std::isspace(c) || c == '$' || c == '#') continue;
-      result += std::tolower(c);
-    }
+  log.sampled = true;
+  log.last = value;
+  if (stream) stream->change(time, log.index, value);
+  else log.history.push_back({time, value});
+}
 
-    return result;
-  };
+// The next sample reports every signal, also the ones that did not change
+inline void VcdScope::restartSampling() {
+  for (SignalLog &log: _monitoredSignals) {
+    log.sampled = false;
+  }
+}
 
+inline VcdScope::VCD VcdScope::vcd() const {
   std::vector<VCD::Event> events;
   for (SignalLog const &log: _monitoredSignals) {
     for (auto [time, value]: log.history) {
-      events.emplace_back(toId(log.mod, log.name), time, value, numberOfBits(log.mask));
+      events.emplace_back(log.id, time, value, log.width);
     }
   }
 
+  return {events, definitions()};
+}
+
+inline std::string VcdScope::definitions() const {
   std::ostringstream out;
   out << "$scope module " << _name << " $end\n";
   for (SignalLog const &log : _monitoredSignals) {
-    std::string id = toId(log.mod, log.name);
-    out << "$var wire " << numberOfBits(log.mask) << ' '
-	<< id << " " << id << " $end\n";
+    out << "$var wire " << log.width << ' '
+	<< log.id << " " << reference(log) << " $end\n";
   }
   out << "$upscope $end\n";
   out << "$enddefinitions $end\n\n";
 
-  return {events, out.str()};
+  return out.str();
 }
 
+// The name of a signal in the definitions: module- and signal-name in lower
+// case, without whitespace and characters that have a meaning in VCD
+inline std::string VcdScope::reference(SignalLog const &log) {
+  std::string result;
+  for (char c: log.mod) {
+    if (std::isspace(c) || c == '$' || c == '#') continue;
+    result += std::tolower(c);
+  }
+  result += '_';
+  for (char c: log.name) {
+    if (std::isspace(c) || c == '$' || c == '#') continue;
+    result += std::tolower(c);
+  }
+
+  return result;
+}
+
+// Value changes refer to a signal by a short identifier code, which must be
+// unique among all scopes of the system. Returns the first index that was not
+// used.
+inline size_t VcdScope::assignCodes(size_t first) {
+  for (SignalLog &log: _monitoredSignals) {
+    log.index = first++;
+    log.id = Impl::VcdEncoder::code(log.index);
+  }
+  return first;
+}
 
 inline void VcdScope::monitor(signal_t const *ptr, signal_t mask, std::string const &modName, std::string const &sigName) {
+  static auto const numberOfBits = [](signal_t mask) -> size_t {
+    size_t result = 0;
+    while (mask) {
+      ++result;
+      mask >>= 1;
+    }
+    return result;
+  };
+
   for (SignalLog const &log: _monitoredSignals) {
     if (log.ptr == ptr) return;
   }
-  _monitoredSignals.emplace_back(modName, sigName, ptr, mask);
+  _monitoredSignals.push_back({
+      .mod = modName,
+      .name = sigName,
+      .ptr = ptr,
+      .mask = mask,
+      .id = {},
+      .index = 0,
+      .width = numberOfBits(mask),
+      .last = 0,
+      .sampled = false,
+      .history = {}
+    });
 }
 
 template <typename OutputSignal1, typename OutputSignal2, typename ... OutputSignalRest, typename ModuleType>
@@ -100,6 +141,139 @@ void VcdScope::monitor(ModuleType const &mod) {
   }
 }
 
+inline void VcdScope::relocate(std::unordered_map<signal_t const*, signal_t const*> const &moved) {
+  for (SignalLog &log: _monitoredSignals) {
+    auto const it = moved.find(log.ptr);
+    if (it != moved.end()) log.ptr = it->second;
+  }
+}
+
 inline void VcdScope::monitorClock() {
   monitor(_sys.getClockSignalPointer(), 1, "System", "CLK");
 }
+
+// Identifier codes are numbers in base 94, written with the printable
+// characters from '!' to '~', least significant digit first
+inline std::string Impl::VcdEncoder::code(size_t index) {
+  std::string result;
+  do {
+    result += static_cast<char>('!' + index % 94);
+    index /= 94;
+  } while (index);
+  return result;
+}
+
+inline char *Impl::VcdEncoder::grow(size_t n) {
+  if (_size + n > _buffer.size()) {
+    _buffer.resize(std::max(2 * _buffer.size(), _size + n));
+  }
+  return _buffer.data() + _size;
+}
+
+inline void Impl::VcdEncoder::reserve(size_t n) {
+  grow(n);
+}
+
+inline void Impl::VcdEncoder::write(std::string const &text) {
+  std::copy(text.begin(), text.end(), grow(text.size()));
+  _size += text.size();
+}
+
+inline void Impl::VcdEncoder::change(size_t time, std::string const &code, signal_t value, size_t width) {
+  // Binary digits are copied from a table, one byte of the value at a time
+  static constexpr auto digits = [] {
+    std::array<std::array<char, 8>, 256> table{};
+    for (size_t byte = 0; byte != 256; ++byte) {
+      for (size_t bit = 0; bit != 8; ++bit) {
+	table[byte][bit] = ((byte >> (7 - bit)) & 1) ? '1' : '0';
+      }
+    }
+    return table;
+  }();
+
+  // Longest possible change: '#', a timestamp of up to 20 digits and '\n',
+  // followed by 'b', 64 binary digits, ' ', the code and '\n'
+  constexpr size_t TimeDigits = std::numeric_limits<size_t>::digits10 + 1;
+  constexpr size_t ValueDigits = 8 * sizeof(signal_t);
+  char *out = grow((1 + TimeDigits + 1) + (1 + ValueDigits + 1) + code.size() + 1);
+  if (time != _time) {
+    _time = time;
+    *out++ = '#';
+    out = std::to_chars(out, out + TimeDigits, time).ptr;
+    *out++ = '\n';
+  }
+
+  if (width == 1) {
+    *out++ = (value & 1) ? '1' : '0';
+  }
+  else {
+    size_t const bits = std::max<size_t>(1, std::bit_width(value));
+    size_t const head = (bits - 1) % 8 + 1;
+    size_t shift = bits - head;
+
+    *out++ = 'b';
+    std::memcpy(out, digits[(value >> shift) & 0xff].data() + 8 - head, head);
+    out += head;
+    while (shift != 0) {
+      shift -= 8;
+      std::memcpy(out, digits[(value >> shift) & 0xff].data(), 8);
+      out += 8;
+    }
+    *out++ = ' ';
+  }
+
+  out = std::copy(code.begin(), code.end(), out);
+  *out++ = '\n';
+  _size = out - _buffer.data();
+}
+
+inline size_t Impl::VcdEncoder::size() const {
+  return _size;
+}
+
+inline std::string_view Impl::VcdEncoder::view() const {
+  return {_buffer.data(), _size};
+}
+
+inline std::string Impl::VcdEncoder::take() {
+  _buffer.resize(_size);
+  _size = 0;
+  return std::move(_buffer);
+}
+
+inline void Impl::VcdEncoder::clear() {
+  _size = 0;
+}
+
+inline Impl::VcdStream::VcdStream(std::string const &filename, size_t bufferSize,
+				  std::vector<std::string> const &codes, std::vector<size_t> const &widths):
+  _file(filename, std::ios::binary),
+  _capacity(bufferSize),
+  _codes(codes),
+  _widths(widths)
+{
+  Error::throw_runtime_error_if
+    <Error::VcdFileError>(!_file, filename);
+  _encoder.reserve(_capacity + 128);
+}
+
+inline Impl::VcdStream::~VcdStream() {
+  flush();
+}
+
+inline void Impl::VcdStream::write(std::string const &text) {
+  _encoder.write(text);
+  if (_encoder.size() >= _capacity) flush();
+}
+
+inline void Impl::VcdStream::change(size_t time, size_t signal, signal_t value) {
+  _encoder.change(time, _codes[signal], value, _widths[signal]);
+  if (_encoder.size() >= _capacity) flush();
+}
+
+inline void Impl::VcdStream::flush() {
+  std::string_view const data = _encoder.view();
+  _file.write(data.data(), data.size());
+  _file.flush();
+  _encoder.clear();
+}
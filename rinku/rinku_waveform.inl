@@ -0,0 +1,464 @@
+// Rinku waveform format. A file starts with the definitions of the signals,
+// followed by blocks of value changes. Every block is compressed on its own and
+// starts at a known time, so a reader can skip to the blocks covering the times
+// it is interested in, using the index of the blocks at the end of the file.
+// Files that were not closed properly have no index; their blocks are found by
+// walking from one block to the next. See the readme for the layout.
+
+namespace Impl {
+
+  inline void putVarint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+      out += static_cast<char>((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    out += static_cast<char>(value);
+  }
+
+  inline bool getVarint(char const *&ptr, char const *end, uint64_t &value) {
+    value = 0;
+    for (size_t shift = 0; ptr != end && shift < 64; shift += 7) {
+      uint8_t const byte = *ptr++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+  }
+
+  inline void putString(std::string &out, std::string const &str) {
+    putVarint(out, str.size());
+    out += str;
+  }
+
+  inline bool getString(char const *&ptr, char const *end, std::string &str) {
+    uint64_t size;
+    if (!getVarint(ptr, end, size) || size > static_cast<size_t>(end - ptr)) return false;
+    str.assign(ptr, size);
+    ptr += size;
+    return true;
+  }
+
+  inline void putFixed(std::string &out, uint64_t value) {
+    for (size_t byte = 0; byte != 8; ++byte) {
+      out += static_cast<char>((value >> (8 * byte)) & 0xff);
+    }
+  }
+
+  inline uint64_t getFixed(char const *ptr) {
+    uint64_t value = 0;
+    for (size_t byte = 0; byte != 8; ++byte) {
+      value |= static_cast<uint64_t>(static_cast<uint8_t>(ptr[byte])) << (8 * byte);
+    }
+    return value;
+  }
+
+  // LZ77 compression of a block: a sequence of literal runs, each followed by a
+  // copy of earlier data. A run is stored as its length and its bytes, a copy
+  // as its length (minus 3, so that 0 can mark the end) and its distance.
+  // Matches are found through chains of earlier positions with the same hash.
+  inline constexpr size_t LzMinMatch = 4;
+
+  inline std::string compress(std::string_view raw) {
+    static constexpr size_t HashBits = 16;
+    static constexpr size_t MaxChain = 16;
+    static constexpr uint32_t None = -1;
+
+    std::vector<uint32_t> head(size_t(1) << HashBits, None);
+    std::vector<uint32_t> previous(raw.size(), None);
+    auto const insert = [&](size_t pos) {
+      uint32_t word;
+      std::memcpy(&word, raw.data() + pos, 4);
+      uint32_t const hash = (word * 2654435761u) >> (32 - HashBits);
+      previous[pos] = head[hash];
+      head[hash] = pos;
+      return previous[pos];
+    };
+
+    std::string out;
+    size_t literals = 0;
+    size_t pos = 0;
+    while (pos + LzMinMatch <= raw.size()) {
+      size_t bestLength = 0;
+      size_t bestDistance = 0;
+      uint32_t candidate = insert(pos);
+      for (size_t chain = 0; candidate != None && chain != MaxChain; ++chain, candidate = previous[candidate]) {
+	size_t length = 0;
+	while (pos + length != raw.size() && raw[candidate + length] == raw[pos + length]) ++length;
+	if (length > bestLength) {
+	  bestLength = length;
+	  bestDistance = pos - candidate;
+	}
+      }
+
+      if (bestLength < LzMinMatch) {
+	++pos;
+	continue;
+      }
+
+      putVarint(out, pos - literals);
+      out.append(raw.substr(literals, pos - literals));
+      putVarint(out, bestLength - LzMinMatch + 1);
+      putVarint(out, bestDistance);
+
+      size_t const end = pos + bestLength;
+      while (++pos != end) {
+	if (pos + LzMinMatch <= raw.size()) insert(pos);
+      }
+      literals = pos;
+    }
+
+    putVarint(out, raw.size() - literals);
+    out.append(raw.substr(literals));
+    putVarint(out, 0);
+    return out;
+  }
+
+  inline bool decompress(std::string_view data, size_t rawSize, std::string &raw) {
+    raw.clear();
+    raw.reserve(rawSize);
+
+    char const *ptr = data.data();
+    char const *const end = ptr + data.size();
+    while (true) {
+      uint64_t literals, length, distance;
+      if (!getVarint(ptr, end, literals) || literals > static_cast<size_t>(end - ptr) ||
+	  raw.size() + literals > rawSize) return false;
+      raw.append(ptr, literals);
+      ptr += literals;
+
+      if (!getVarint(ptr, end, length)) return false;
+      if (length == 0) return raw.size() == rawSize;
+
+      length += LzMinMatch - 1;
+      if (!getVarint(ptr, end, distance) || distance == 0 || distance > raw.size() ||
+	  raw.size() + length > rawSize) return false;
+
+      // The copy may overlap the bytes it produces
+      size_t const from = raw.size() - distance;
+      for (size_t idx = 0; idx != length; ++idx) {
+	raw += raw[from + idx];
+      }
+    }
+  }
+} // namespace Impl
+
+
+// Within a block, every record starts with a varint. An odd value moves the
+// time forward by half the value. An even value is a change of the signal that
+// follows the previous change of the same time by (value >> 2) positions; the
+// new value of a 1-bit signal is in bit 1, wider signals are followed by their
+// value as another varint.
+inline Impl::WaveWriter::WaveWriter(std::ostream &out, std::string const &timescale,
+				    std::vector<Waveform::Signal> const &signals, size_t blockSize):
+  _out(out),
+  _blockSize(blockSize)
+{
+  std::string definitions;
+  putString(definitions, timescale);
+  putVarint(definitions, signals.size());
+  for (Waveform::Signal const &signal: signals) {
+    putString(definitions, signal.scope);
+    putString(definitions, signal.name);
+    putVarint(definitions, signal.width);
+    _widths.push_back(signal.width);
+  }
+
+  std::string header = "RINKUWF1";
+  putFixed(header, definitions.size());
+  write(header + definitions);
+}
+
+inline void Impl::WaveWriter::write(std::string const &bytes) {
+  _out.write(bytes.data(), bytes.size());
+  _offset += bytes.size();
+}
+
+inline void Impl::WaveWriter::change(size_t time, size_t signal, signal_t value) {
+  // Time can only move forward within a block
+  if (!_block.empty() && time < _time) flushBlock();
+
+  if (_block.empty()) {
+    _first = _time = time;
+    _next = 0;
+  }
+  else if (time != _time || signal < _next) {
+    putVarint(_block, ((time - _time) << 1) | 1);
+    _time = time;
+    _next = 0;
+  }
+
+  size_t const skip = signal - _next;
+  if (_widths[signal] == 1) {
+    putVarint(_block, (skip << 2) | ((value & 1) << 1));
+  }
+  else {
+    putVarint(_block, skip << 2);
+    putVarint(_block, value);
+  }
+  _next = signal + 1;
+  ++_changes;
+
+  if (_block.size() >= _blockSize) flushBlock();
+}
+
+inline void Impl::WaveWriter::flushBlock() {
+  if (_block.empty()) return;
+
+  // Blocks that do not get smaller are stored as they are
+  std::string const packed = compress(_block);
+  bool const stored = packed.size() >= _block.size();
+
+  std::string header = "B";
+  putVarint(header, _first);
+  putVarint(header, _time);
+  putVarint(header, _changes);
+  putVarint(header, _block.size());
+  putVarint(header, stored ? _block.size() : packed.size());
+
+  _index.push_back({_offset, _first, _time});
+  write(header);
+  write(stored ? _block : packed);
+  _block.clear();
+  _changes = 0;
+}
+
+inline void Impl::WaveWriter::finish() {
+  if (_finished) return;
+  _finished = true;
+
+  flushBlock();
+  size_t const offset = _offset;
+  std::string index = "I";
+  putVarint(index, _index.size());
+  for (auto const &[blockOffset, first, last]: _index) {
+    putVarint(index, blockOffset);
+    putVarint(index, first);
+    putVarint(index, last);
+  }
+  putFixed(index, offset);
+  index += "RINKUIDX";
+  write(index);
+  _out.flush();
+}
+
+inline Impl::WaveStream::WaveStream(std::string const &filename, std::string const &timescale,
+				    std::vector<Waveform::Signal> const &signals, size_t blockSize):
+  _file(filename, std::ios::binary),
+  _writer(_file, timescale, signals, blockSize)
+{
+  Error::throw_runtime_error_if
+    <Error::WaveformFileError>(!_file, filename);
+}
+
+inline Impl::WaveStream::~WaveStream() {
+  _writer.finish();
+}
+
+inline void Impl::WaveStream::change(size_t time, size_t signal, signal_t value) {
+  _writer.change(time, signal, value);
+}
+
+
+inline Waveform::Waveform(std::string const &filename):
+  _filename(filename),
+  _file(filename, std::ios::binary)
+{
+  Error::throw_runtime_error_if
+    <Error::WaveformFileError>(!_file, filename);
+
+  _file.seekg(0, std::ios::end);
+  _fileSize = _file.tellg();
+
+  std::string const header = readBytes(0, 16);
+  if (header.size() != 16 || header.substr(0, 8) != "RINKUWF1") invalid("unknown header");
+  size_t const length = Impl::getFixed(header.data() + 8);
+  if (length > _fileSize - 16) invalid("truncated definitions");
+
+  std::string const definitions = readBytes(16, length);
+  char const *ptr = definitions.data();
+  char const *const end = ptr + definitions.size();
+  uint64_t count;
+  if (!Impl::getString(ptr, end, _timescale) || !Impl::getVarint(ptr, end, count)) invalid("truncated definitions");
+  for (size_t idx = 0; idx != count; ++idx) {
+    Signal signal;
+    uint64_t width;
+    if (!Impl::getString(ptr, end, signal.scope) || !Impl::getString(ptr, end, signal.name) ||
+	!Impl::getVarint(ptr, end, width) || width == 0 || width > 64) invalid("truncated definitions");
+    signal.width = width;
+    _signals.push_back(signal);
+  }
+
+  if (!readIndex()) scanBlocks(16 + length);
+}
+
+inline std::string const &Waveform::timescale() const {
+  return _timescale;
+}
+
+inline std::vector<Waveform::Signal> const &Waveform::signals() const {
+  return _signals;
+}
+
+inline size_t Waveform::firstTime() const {
+  return _blocks.empty() ? 0 : _blocks.front().first;
+}
+
+inline size_t Waveform::lastTime() const {
+  size_t last = 0;
+  for (Block const &block: _blocks) {
+    last = std::max(last, block.last);
+  }
+  return last;
+}
+
+// Calls the callback for every change between times 'from' and 'to'
+// (inclusive), in order of time. Only the blocks covering that range are read.
+template <typename Callback>
+void Waveform::read(Callback &&callback, size_t from, size_t to) const {
+  for (Block const &block: _blocks) {
+    if (block.last < from || block.first > to) continue;
+
+    std::string const raw = readBlock(block);
+    char const *ptr = raw.data();
+    char const *const end = ptr + raw.size();
+    size_t time = block.first;
+    size_t next = 0;
+    while (ptr != end) {
+      uint64_t record;
+      if (!Impl::getVarint(ptr, end, record)) invalid("truncated block");
+      if (record & 1) {
+	time += record >> 1;
+	next = 0;
+	continue;
+      }
+
+      size_t const signal = next + (record >> 2);
+      if (signal >= _signals.size()) invalid("change of an unknown signal");
+
+      uint64_t value = (record >> 1) & 1;
+      if (_signals[signal].width != 1 && !Impl::getVarint(ptr, end, value)) invalid("truncated block");
+      next = signal + 1;
+
+      if (time > to) break;
+      if (time >= from) callback(Change{time, signal, value});
+    }
+  }
+}
+
+// Writes the changes between times 'from' and 'to' as VCD, in the same way as
+// System::vcd() (except for the date, which is not stored)
+inline void Waveform::vcd(std::ostream &out, size_t from, size_t to) const {
+  Impl::VcdEncoder encoder;
+  encoder.write("$version Rinku VCD Dump $end\n");
+  encoder.write("$timescale " + _timescale + " $end\n\n");
+
+  std::vector<std::string> codes;
+  for (size_t idx = 0; idx != _signals.size(); ++idx) {
+    codes.push_back(Impl::VcdEncoder::code(idx));
+  }
+
+  for (size_t idx = 0; idx != _signals.size(); ) {
+    std::string const &scope = _signals[idx].scope;
+    encoder.write("$scope module " + scope + " $end\n");
+    for (; idx != _signals.size() && _signals[idx].scope == scope; ++idx) {
+      encoder.write("$var wire " + std::to_string(_signals[idx].width) + ' ' +
+		    codes[idx] + ' ' + _signals[idx].name + " $end\n");
+    }
+    encoder.write("$upscope $end\n");
+    encoder.write("$enddefinitions $end\n\n");
+  }
+
+  auto const flush = [&] {
+    std::string_view const data = encoder.view();
+    out.write(data.data(), data.size());
+    encoder.clear();
+  };
+
+  read([&](Change const &change) {
+    encoder.change(change.time, codes[change.signal], change.value, _signals[change.signal].width);
+    if (encoder.size() >= (1 << 16)) flush();
+  }, from, to);
+  flush();
+}
+
+// The index is found through the last 16 bytes of the file: its offset and a
+// marker
+inline bool Waveform::readIndex() {
+  if (_fileSize < 32) return false;
+  std::string const trailer = readBytes(_fileSize - 16, 16);
+  if (trailer.substr(8) != "RINKUIDX") return false;
+
+  size_t const offset = Impl::getFixed(trailer.data());
+  if (offset >= _fileSize - 16) return false;
+
+  std::string const index = readBytes(offset, _fileSize - 16 - offset);
+  char const *ptr = index.data();
+  char const *const end = ptr + index.size();
+  uint64_t count;
+  if (*ptr++ != 'I' || !Impl::getVarint(ptr, end, count)) return false;
+
+  std::vector<Block> blocks;
+  for (size_t idx = 0; idx != count; ++idx) {
+    uint64_t blockOffset, first, last;
+    if (!Impl::getVarint(ptr, end, blockOffset) || !Impl::getVarint(ptr, end, first) ||
+	!Impl::getVarint(ptr, end, last)) return false;
+
+    Block block;
+    if (!readBlockHeader(blockOffset, block) || block.first != first || block.last != last) return false;
+    blocks.push_back(block);
+  }
+  _blocks = std::move(blocks);
+  return true;
+}
+
+// Without an index, the blocks are visited one after the other. A block that
+// was only partly written ends the search.
+inline void Waveform::scanBlocks(size_t offset) {
+  Block block;
+  while (readBlockHeader(offset, block)) {
+    _blocks.push_back(block);
+    offset = block.payload + block.storedSize;
+  }
+}
+
+inline bool Waveform::readBlockHeader(size_t offset, Block &block) const {
+  // A marker and five varints
+  std::string const header = readBytes(offset, 1 + 5 * 10);
+  if (header.empty() || header[0] != 'B') return false;
+
+  char const *ptr = header.data() + 1;
+  char const *const end = header.data() + header.size();
+  uint64_t changes;
+  if (!Impl::getVarint(ptr, end, block.first) || !Impl::getVarint(ptr, end, block.last) ||
+      !Impl::getVarint(ptr, end, changes) || !Impl::getVarint(ptr, end, block.rawSize) ||
+      !Impl::getVarint(ptr, end, block.storedSize)) return false;
+
+  block.offset = offset;
+  block.payload = offset + (ptr - header.data());
+  return block.storedSize <= block.rawSize && block.payload + block.storedSize <= _fileSize;
+}
+
+inline std::string Waveform::readBlock(Block const &block) const {
+  std::string data = readBytes(block.payload, block.storedSize);
+  if (block.storedSize == block.rawSize) return data;
+
+  std::string raw;
+  if (!Impl::decompress(data, block.rawSize, raw)) invalid("corrupt block");
+  return raw;
+}
+
+inline std::string Waveform::readBytes(size_t offset, size_t count) const {
+  if (offset >= _fileSize) return {};
+  count = std::min(count, _fileSize - offset);
+
+  std::string bytes(count, '\0');
+  _file.clear();
+  _file.seekg(offset);
+  _file.read(bytes.data(), count);
+  return bytes;
+}
+
+inline void Waveform::invalid(std::string const &reason) const {
+  Error::throw_runtime_error<Error::InvalidWaveform>(_filename, reason);
+  UNREACHABLE__;
+}
@@ -0,0 +1,175 @@
+// Wire modules only route bits from their inputs to their outputs, like a bus,
+// a splitter or a joiner (see ModuleBase::wiring()). When the system is
+// initialized, every input that is connected to a wire is connected to the
+// drivers of that wire instead, each with the shift and mask that select the
+// bits passing through it. A module that reads a wire is therefore updated in
+// the same wave as the modules driving the wire, and the wire itself is taken
+// out of the fanout of its drivers, so it is no longer updated while settling.
+// Its outputs are derived from its inputs when they are read with getOutput(),
+// and brought up to date before a scope that monitors them is sampled. A wire
+// whose outputs are set from outside or whose updates are disabled, as the
+// debugger's poke does, is put back in place before the system settles again
+// (see System::reconfigure()).
+
+inline void System::aliasWires() {
+  _stats.aliasedWires = 0;
+  _wires.clear();
+
+  std::vector<int> const &owner = _signalOwner;
+  std::vector<int> const &reader = _slotReader;
+
+  auto const arenaIndex = [&](signal_t const *ptr) -> std::optional<size_t> {
+    if (ptr < _signals.data() || ptr >= _signals.data() + _signals.size()) return std::nullopt;
+    return ptr - _signals.data();
+  };
+
+  // Wires with clock handlers and wires that are read through an inverted
+  // output are left in place
+  using WireTerm = Impl::ModuleBase::WireTerm;
+  std::vector<std::vector<std::vector<WireTerm>>> terms(_moduleCount);
+  std::vector<bool> wire(_moduleCount, false);
+  for (size_t idx = 0; idx != _moduleCount; ++idx) {
+    Impl::ModuleBase const &m = *_modules[idx];
+    if (m.nOutputs() == 0 || !m.updateEnabled() || _keptWires[idx] || _clocked[idx]) continue;
+
+    terms[idx].resize(m.nOutputs());
+    wire[idx] = true;
+    for (size_t output = 0; output != m.nOutputs() && wire[idx]; ++output) {
+      wire[idx] = m.wireTerms(output, terms[idx][output]);
+    }
+  }
+
+  for (size_t slot = 0; slot != reader.size(); ++slot) {
+    for (Impl::Driver const &driver: _netlist.inputRow(slot)) {
+      std::optional<size_t> const signal = arenaIndex(driver.ptr);
+      if (signal && driver.activeLow) wire[owner[*signal]] = false;
+    }
+  }
+
+  // A loop made of wires alone has no driver to alias to. Peel off the wires
+  // that are not driven by another wire until only such loops (and the wires
+  // behind them) remain, and leave those in place as well.
+  {
+    std::vector<size_t> wireDrivers(_moduleCount, 0);
+    std::vector<std::vector<int>> wireReaders(_moduleCount);
+    for (size_t slot = this->nInputs(); slot != reader.size(); ++slot) {
+      if (!wire[reader[slot]]) continue;
+      for (Impl::Driver const &driver: _netlist.inputRow(slot)) {
+	std::optional<size_t> const signal = arenaIndex(driver.ptr);
+	if (!signal || !wire[owner[*signal]]) continue;
+	++wireDrivers[reader[slot]];
+	wireReaders[owner[*signal]].push_back(reader[slot]);
+      }
+    }
+
+    std::vector<int> ready;
+    for (size_t idx = 0; idx != _moduleCount; ++idx) {
+      if (wire[idx] && wireDrivers[idx] == 0) ready.push_back(idx);
+    }
+    while (!ready.empty()) {
+      int const w = ready.back();
+      ready.pop_back();
+      for (int next: wireReaders[w]) {
+	if (--wireDrivers[next] == 0) ready.push_back(next);
+      }
+    }
+    for (size_t idx = 0; idx != _moduleCount; ++idx) {
+      if (wireDrivers[idx] != 0) wire[idx] = false;
+    }
+  }
+
+  _stats.aliasedWires = std::count(wire.begin(), wire.end(), true);
+  _aliasedWires = wire;
+  if (_stats.aliasedWires == 0) return;
+
+  // Replace every driver that is a wire by the drivers of the wire, narrowed
+  // down to the bits that pass through it. Wires can be chained.
+  auto const expand = [&](auto const &self, Impl::Driver const &driver,
+			  std::vector<Impl::Driver> &row, signal_t &constant) -> void {
+    std::optional<size_t> const signal = arenaIndex(driver.ptr);
+    if (!signal || !wire[owner[*signal]]) {
+      // Drivers that take bits from the same signal in the same way are merged
+      auto const same = std::find_if(row.begin(), row.end(), [&](Impl::Driver const &other) {
+	return other.ptr == driver.ptr && other.activeLow == driver.activeLow &&
+	  other.shift == driver.shift && other.offset == driver.offset;
+      });
+      if (same == row.end()) row.push_back(driver);
+      else same->mask |= driver.mask;
+      return;
+    }
+
+    int const w = owner[*signal];
+    for (WireTerm const &term: terms[w][*signal - _firstSignal[w]]) {
+      size_t const slot = _firstInputSlot[w] + term.input;
+      constant |= driver.select(((_netlist.constants()[slot] >> term.shift) & term.mask) << term.offset);
+      for (Impl::Driver source: _netlist.inputRow(slot)) {
+	if (source.narrow(term.shift, term.offset, term.mask) &&
+	    source.narrow(driver.shift, driver.offset, driver.mask)) {
+	  self(self, source, row, constant);
+	}
+      }
+    }
+  };
+
+  Impl::Netlist aliased;
+  std::vector<std::vector<int>> readers(_signals.size());
+  for (size_t slot = 0; slot != reader.size(); ++slot) {
+    std::vector<Impl::Driver> row;
+    signal_t constant = _netlist.constants()[slot];
+    for (Impl::Driver const &driver: _netlist.inputRow(slot)) {
+      expand(expand, driver, row, constant);
+    }
+    aliased.addInput(row, constant);
+
+    for (Impl::Driver const &driver: row) {
+      std::optional<size_t> const signal = arenaIndex(driver.ptr);
+      if (!signal) continue;
+      std::vector<int> &r = readers[*signal];
+      if (std::find(r.begin(), r.end(), reader[slot]) == r.end()) r.push_back(reader[slot]);
+    }
+  }
+
+  // The outputs of the system come first, followed by the signal arena. The
+  // modules that read a wire now read its drivers, so they move over to the
+  // fanout of the drivers, and the wire drops out of it.
+  auto const keep = [&](std::span<int const> old, std::vector<int> const &added) {
+    std::vector<int> fanout;
+    for (int r: old) {
+      if (r < 0 || !wire[r]) fanout.push_back(r);
+    }
+    for (int r: added) {
+      if ((r < 0 || !wire[r]) && std::find(fanout.begin(), fanout.end(), r) == fanout.end()) fanout.push_back(r);
+    }
+    return fanout;
+  };
+  
+  for (size_t slot = 0; slot != this->nOutputs(); ++slot) {
+    aliased.addOutput(keep(_netlist.fanoutRow(slot), {}));
+  }
+  for (size_t signal = 0; signal != _signals.size(); ++signal) {
+    std::span<int const> const old = _netlist.fanoutRow(this->nOutputs() + signal);
+    aliased.addOutput(wire[owner[signal]] ? std::vector<int>{} : keep(old, readers[signal]));
+  }
+  _netlist = std::move(aliased);
+
+  std::vector<bool> monitored(_moduleCount, false);
+  for (auto const &scope: _scopes) {
+    for (VcdScope::SignalLog const &log: scope->_monitoredSignals) {
+      std::optional<size_t> const signal = arenaIndex(log.ptr);
+      if (signal) monitored[owner[*signal]] = true;
+    }
+  }
+  
+  for (int idx: _worklist.schedule()) {
+    if (!wire[idx]) continue;
+    _modules[idx]->alias(std::move(terms[idx]));
+    if (monitored[idx]) _wires.push_back(idx);
+  }
+  std::erase_if(_alwaysUpdated, [&](int idx) { return wire[idx]; });
+}
+
+inline void System::refreshWires() {
+  for (int idx: _wires) {
+    _modules[idx]->refreshWire();
+  }
+}
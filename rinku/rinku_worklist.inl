@@ -0,0 +1,136 @@
+// The worklist is a bitset of pending modules, indexed by the rank of each
+// module in the static evaluation schedule. The schedule is a topological
+// order of the module graph in which the modules of a combinational loop are
+// contiguous. Draining the worklist always evaluates the pending module with the
+// lowest rank, so a full settle evaluates every acyclic module exactly once,
+// while modules in a loop are revisited until the loop has settled. The bitset
+// has a fixed size, so no allocations take place once the system is running.
+
+inline void Worklist::resize(std::vector<int> const &schedule) {
+  _schedule = schedule;
+  _rank.assign(schedule.size(), 0);
+  for (size_t rank = 0; rank != schedule.size(); ++rank) {
+    _rank[schedule[rank]] = rank;
+  }
+  
+  _pending.assign((schedule.size() + 63) / 64, 0);
+  _cursor = _pending.size();
+  _guaranteed.reserve(schedule.size());
+}
+
+inline std::vector<int> const &Worklist::schedule() const {
+  return _schedule;
+}
+
+inline void Worklist::push(int idx) {
+  if (idx < 0) return;
+  
+  size_t const rank = _rank[idx];
+  size_t const word = rank >> 6;
+  _pending[word] |= (uint64_t(1) << (rank & 63));
+  _cursor = std::min(_cursor, word);
+}
+
+inline void Worklist::notify(int idx) {
+  // Used by stateChanged(), which may be called from clock handlers running
+  // on different threads. Shared pushes do not move the cursor; it is reset
+  // when sharing ends.
+  if (!_shared) return push(idx);
+  if (idx < 0) return;
+  
+  size_t const rank = _rank[idx];
+  std::atomic_ref<uint64_t>(_pending[rank >> 6]).fetch_or(uint64_t(1) << (rank & 63), std::memory_order_relaxed);
+}
+
+inline void Worklist::share(bool value) {
+  _shared = value;
+  if (!value) _cursor = 0;
+}
+
+inline void Worklist::pushAll() {
+  if (_pending.empty()) return;
+  
+  std::fill(_pending.begin(), _pending.end(), ~uint64_t(0));
+  if (size_t const tail = _schedule.size() & 63) {
+    _pending.back() = (uint64_t(1) << tail) - 1;
+  }
+  _cursor = 0;
+}
+
+template <typename Visitor>
+void Worklist::drain(Visitor &&visit) {
+  // Modules may push modules with a lower rank than the current one (only
+  // within a loop), in which case the cursor moves back to pick them up.
+  while (_cursor < _pending.size()) {
+    uint64_t &word = _pending[_cursor];
+    if (word == 0) {
+      ++_cursor;
+      continue;
+    }
+
+    size_t const rank = (_cursor << 6) + std::countr_zero(word);
+    word &= (word - 1);
+    visit(_schedule[rank]);
+  }
+}
+
+inline void Worklist::guarantee(int idx) {
+  if (idx >= 0) _guaranteed.push_back(idx);
+}
+
+template <typename Visitor>
+void Worklist::releaseGuarantees(Visitor &&visit) {
+  for (int idx: _guaranteed) {
+    visit(idx);
+  }
+  _guaranteed.clear();
+}
+
+inline size_t Worklist::lowestPending() {
+  // Returns the size of the schedule when nothing is pending
+  while (_cursor < _pending.size() && _pending[_cursor] == 0) {
+    ++_cursor;
+  }
+  if (_cursor == _pending.size()) return _schedule.size();
+  return (_cursor << 6) + std::countr_zero(_pending[_cursor]);
+}
+
+inline void Worklist::take(size_t begin, size_t end, std::vector<int> &modules) {
+  // Remove the pending modules with a rank in [begin, end) and append them to
+  // modules, in schedule order.
+  if (begin >= end) return;
+  
+  size_t const first = begin >> 6;
+  size_t const last = (end - 1) >> 6;
+  for (size_t word = first; word <= last; ++word) {
+    uint64_t mask = ~uint64_t(0);
+    if (word == first) mask &= ~uint64_t(0) << (begin & 63);
+    if (word == last) mask &= ~uint64_t(0) >> (63 - ((end - 1) & 63));
+
+    uint64_t bits = _pending[word] & mask;
+    _pending[word] &= ~mask;
+    while (bits) {
+      modules.push_back(_schedule[(word << 6) + std::countr_zero(bits)]);
+      bits &= (bits - 1);
+    }
+  }
+}
+
+inline void Worklist::erase(int idx) {
+  size_t const rank = _rank[idx];
+  _pending[rank >> 6] &= ~(uint64_t(1) << (rank & 63));
+}
+
+inline void Worklist::merge(Worklist &other) {
+  // Move everything that is pending or guaranteed in other into this worklist.
+  // Both must have been resized to the same schedule.
+  for (size_t word = other._cursor; word < other._pending.size(); ++word) {
+    _pending[word] |= other._pending[word];
+    other._pending[word] = 0;
+  }
+  _cursor = std::min(_cursor, other._cursor);
+  other._cursor = other._pending.size();
+  
+  _guaranteed.insert(_guaranteed.end(), other._guaranteed.begin(), other._guaranteed.end());
+  other._guaranteed.clear();
+}
@@ -16,10 +16,16 @@ namespace Rinku {
 	    
     class Bus: RINKU_MODULE(BusInputs, BusOutputs) {
     public:
-      virtual void update(GuaranteeToken) override {
+      RINKU_PURE_UPDATE() {
 	size_t const data = getInput<BUS_DATA_IN>();
 	setOutput<BUS_DATA_OUT>(data);
       }
+
+      // Readers of the bus read its drivers directly, see System::init()
+      virtual bool wiring(size_t, std::vector<WireTerm> &terms) const override {
+	terms.push_back({.input = 0});
+	return true;
+      }
     };
     
   } // namespace Util
@@ -11,11 +11,15 @@ namespace Rinku {
     class Clock: RINKU_MODULE(ClockOutput) {
       bool state = false;
     public:
+      RINKU_EVENT_DRIVEN();
+      
       RINKU_ON_CLOCK_RISING() {
 	state = true;
+	RINKU_STATE_CHANGED();
       }
       RINKU_ON_CLOCK_FALLING() {
 	state = false;
+	RINKU_STATE_CHANGED();
       }
       RINKU_UPDATE() {
 	RINKU_GUARANTEE_NO_GET_INPUT();
@@ -55,6 +55,8 @@ namespace Rinku {
       static_assert(N <= Inputs::N, "Number of joiner inputs (N) is larger than 64.");
       
     public:
+      RINKU_EVENT_DRIVEN();
+      
       virtual void update(GuaranteeToken) override {
 	size_t result = 0;
 	for (size_t idx = 0; idx != N; ++idx) {
@@ -64,6 +66,13 @@ namespace Rinku {
 	setOutput<JOINER_OUT>(result);
       }
 
+      virtual bool wiring(size_t, std::vector<WireTerm> &terms) const override {
+	for (size_t idx = 0; idx != N; ++idx) {
+	  terms.push_back({.input = idx, .offset = uint8_t(idx), .mask = 1});
+	}
+	return true;
+      }
+
       virtual size_t usedInputs() const override {
 	return N;
       }
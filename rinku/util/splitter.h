@@ -55,25 +55,18 @@ namespace Rinku {
     class Splitter: RINKU_MODULE(SplitterInputs, SplitterOutputs) {
       static_assert(N <= Outputs::N, "Number of splitter inputs (N) is larger than 64.");
 
-      signal_t currentOutput = 0;
-      bool initialized = false;
-      
     public:
-      virtual void update(GuaranteeToken) override {
+      // Not updated when the input is the same as before
+      RINKU_PURE_UPDATE() {
 	signal_t input = getInput<SPLITTER_IN>();
-	if (initialized && input == currentOutput)
-	  return;
-	
 	for (size_t idx = 0; idx != N; ++idx) {
 	  setOutput(idx, (input >> idx));
 	}
-
-	initialized = true;
-	currentOutput = input;
       }
 
-      virtual void reset() override {
-	initialized = false;
+      virtual bool wiring(size_t output, std::vector<WireTerm> &terms) const override {
+	if (output < N) terms.push_back({.input = 0, .shift = uint8_t(output), .mask = 1});
+	return true;
       }
 
       virtual size_t usedOutputs() const override {
@@ -13,12 +13,16 @@ namespace Rinku {
     struct Switch: RINKU_MODULE(SwitchOutputs) {
       bool state = false;
     public:
+      RINKU_EVENT_DRIVEN();
+      
       void set(bool val) {
 	state = val;
+	RINKU_STATE_CHANGED();
       }
   
       void toggle() {
 	state = !state;
+	RINKU_STATE_CHANGED();
       }
   
       RINKU_UPDATE() {
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "../examples/bfcpu/bfcpu.h"
+
+// Runs N independent BFComputer instances of the bfcpu example, first one after
+// the other and then all at once on separate threads, and checks that every
+// concurrent run produced exactly the same result as its serial counterpart.
+// Systems must not share any state while settling.
+
+struct Result {
+  size_t cycles = 0;
+  Rinku::signal_t exitCode = 0;
+  std::string screen;
+  std::string vcd;
+
+  bool operator==(Result const &) const = default;
+};
+
+Result simulate(std::string const &filename, size_t maxCycles) {
+  Result result;
+  std::ostringstream screen;
+
+  BFComputer cpu(filename, 1e5, screen);
+  while (result.cycles != maxCycles && cpu.step(true)) {
+    ++result.cycles;
+  }
+
+  // Strip the $date line, which depends on the time the trace was generated
+  std::string const vcd = cpu.vcd();
+  result.vcd = vcd.substr(vcd.find('\n'));
+  result.exitCode = cpu.getInput<Rinku::SYS_EXIT_CODE>();
+  result.screen = screen.str();
+  return result;
+}
+
+int main(int argc, char **argv) try {
+  std::string const program = (argc > 1) ? argv[1] : "../examples/bfcpu/programs/factorial.bin";
+  size_t const instances = (argc > 2) ? std::stoul(argv[2]) : 8;
+  size_t const maxCycles = (argc > 3) ? std::stoul(argv[3]) : 20'000;
+
+  std::vector<Result> serial(instances);
+  for (size_t idx = 0; idx != instances; ++idx) {
+    serial[idx] = simulate(program, maxCycles);
+  }
+
+  std::vector<Result> parallel(instances);
+  std::vector<std::thread> threads;
+  for (size_t idx = 0; idx != instances; ++idx) {
+    threads.emplace_back([&, idx]() {
+      parallel[idx] = simulate(program, maxCycles);
+    });
+  }
+  for (auto &t: threads) {
+    t.join();
+  }
+
+  size_t mismatches = 0;
+  for (size_t idx = 0; idx != instances; ++idx) {
+    if (parallel[idx] != serial[idx]) {
+      std::cerr << "Instance " << idx << ": concurrent run differs from serial run.\n";
+      ++mismatches;
+    }
+  }
+
+  std::cout << instances << " instances, " << serial[0].cycles << " cycles each, exit code "
+	    << serial[0].exitCode << ": " << (mismatches ? "FAILED" : "OK") << '\n';
+  return mismatches ? 1 : 0;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
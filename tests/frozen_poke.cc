@@ -0,0 +1,86 @@
+#include <iostream>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../rinku/rinku.h"
+
+// Two pure inverters in a row, the first of which is hardwired to a constant,
+// are frozen at init(). Setting the output of the first one from outside (as
+// the debugger's poke does) must reach the second one, and the poked value
+// must be recomputed once the first inverter is enabled again, by updateAll()
+// and by reset(). Afterwards, both inverters are frozen again.
+
+using namespace Rinku;
+
+// ------------ INVERTER --------------
+INPUT(INV_IN, 1);
+OUTPUT(INV_OUT, 1);
+SIGNAL_LIST(InverterInputs, INV_IN);
+SIGNAL_LIST(InverterOutputs, INV_OUT);
+
+class Inverter: MODULE(InverterInputs, InverterOutputs) {
+public:
+  PURE_UPDATE() {
+    SET_OUTPUT(INV_OUT, !GET_INPUT(INV_IN));
+  }
+};
+
+// ------------ SYSTEM --------------
+class Inverters: public System {
+public:
+  Inverter *first;
+  Inverter *second;
+
+  Inverters(size_t tableBits) {
+    first = &addModule<Inverter>("first");
+    second = &addModule<Inverter>("second");
+    CONNECT_CONST(*first, INV_IN, 1);
+    second->connect<INV_IN, INV_OUT>(*first);
+    tabulatePureModules(tableBits);
+    init();
+  }
+
+  bool outputs(signal_t a, signal_t b) const {
+    return first->getOutput<INV_OUT>() == a && second->getOutput<INV_OUT>() == b;
+  }
+};
+
+bool check(size_t tableBits) {
+  Inverters sys(tableBits);
+  bool ok = sys.outputs(0, 1) && (sys.statistics().frozenModules == 2);
+
+  // Poke, step while disabled, enable and step again
+  sys.first->setOutput<INV_OUT>(1);
+  sys.first->enableUpdate(false);
+  sys.updateAll();
+  ok = ok && sys.outputs(1, 0);
+  sys.step();
+  ok = ok && sys.outputs(1, 0) && (sys.statistics().frozenModules == 0);
+  sys.first->enableUpdate(true);
+  sys.step();
+  ok = ok && sys.outputs(0, 1) && (sys.statistics().frozenModules == 2);
+
+  // Set the output of an enabled module
+  sys.first->setOutput<INV_OUT>(1);
+  sys.step();
+  ok = ok && sys.outputs(0, 1);
+
+  sys.first->setOutput<INV_OUT>(1);
+  sys.updateAll();
+  ok = ok && sys.outputs(0, 1);
+
+  sys.first->setOutput<INV_OUT>(1);
+  sys.reset();
+  ok = ok && sys.outputs(0, 1) && (sys.statistics().frozenModules == 2);
+
+  std::cout << "Table bits " << tableBits << ": " << (ok ? "OK" : "FAILED") << '\n';
+  return ok;
+}
+
+int main() try {
+  bool const ok = check(16) & check(0);
+  return ok ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../rinku/rinku.h"
+#include "../rinku/logic/logic.h"
+
+// Poking a gate that is part of a fused logic block, the way the debugger does
+// (set its output and disable its updates), must survive the next settle, and
+// the gates reading it must see the poked value. Once the gate is enabled
+// again, it rejoins the block.
+
+using namespace Rinku;
+using namespace Rinku::Logic;
+
+// ------------ SOURCE --------------
+OUTPUT(SRC_A, 1);
+OUTPUT(SRC_B, 1);
+SIGNAL_LIST(SourceOutputs, SRC_A, SRC_B);
+
+class Source: MODULE(SourceOutputs) {
+public:
+  EVENT_DRIVEN();
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(SRC_A, 1);
+    SET_OUTPUT(SRC_B, 0);
+  }
+};
+
+// ------------ SYSTEM --------------
+class Gates: public System {
+public:
+  And *first;
+  Or *second;
+
+  Gates() {
+    auto &source = addModule<Source>("src");
+    first = &addModule<And>("and");
+    second = &addModule<Or>("or");
+    first->connect<AND_IN_A, SRC_A>(source);
+    first->connect<AND_IN_B, SRC_B>(source);
+    second->connect<OR_IN_A, AND_OUT>(*first);
+    second->connect<OR_IN_B, SRC_B>(source);
+    fuseLogic();
+    init();
+  }
+};
+
+int main() try {
+  Gates sys;
+  bool ok = (sys.statistics().fusedGates == 2) && (sys.second->getOutput<OR_OUT>() == 0);
+
+  sys.first->setOutput<AND_OUT>(1);
+  sys.first->enableUpdate(false);
+  sys.updateAll();
+  ok = ok && (sys.first->getOutput<AND_OUT>() == 1) && (sys.second->getOutput<OR_OUT>() == 1);
+
+  sys.step();
+  ok = ok && (sys.first->getOutput<AND_OUT>() == 1) && (sys.second->getOutput<OR_OUT>() == 1);
+
+  sys.first->enableUpdate(true);
+  sys.step();
+  ok = ok && (sys.statistics().fusedGates == 2) &&
+    (sys.first->getOutput<AND_OUT>() == 0) && (sys.second->getOutput<OR_OUT>() == 0);
+
+  std::cout << (ok ? "OK" : "FAILED") << '\n';
+  return ok ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
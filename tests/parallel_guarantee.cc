@@ -0,0 +1,105 @@
+#include <iostream>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../rinku/rinku.h"
+
+// A module that only guarantees not to read its inputs on some cycles must not
+// be placed in the same level as its driver, even if it made the guarantee
+// during init(). Otherwise both are updated at the same time when the level is
+// settled concurrently, which ThreadSanitizer reports as a data race.
+
+using namespace Rinku;
+
+// ------------ SOURCE --------------
+OUTPUT(SRC_OUT, 8);
+SIGNAL_LIST(SourceOutputs, SRC_OUT);
+
+class Source: MODULE(SourceOutputs) {
+  signal_t value = 0;
+public:
+  EVENT_DRIVEN();
+
+  ON_CLOCK_RISING() {
+    ++value;
+    STATE_CHANGED();
+  }
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(SRC_OUT, value);
+  }
+
+  RESET() {
+    value = 0;
+  }
+};
+
+// ------------ GATED --------------
+// Guarantees not to read its input on even ticks only
+INPUT(GATED_IN, 8);
+OUTPUT(GATED_OUT, 8);
+SIGNAL_LIST(GatedInputs, GATED_IN);
+SIGNAL_LIST(GatedOutputs, GATED_OUT);
+
+class Gated: MODULE(GatedInputs, GatedOutputs) {
+  size_t ticks = 0;
+public:
+  EVENT_DRIVEN();
+
+  ON_CLOCK_RISING() {
+    ++ticks;
+    STATE_CHANGED();
+  }
+
+  UPDATE() {
+    if (ticks % 2 == 0) {
+      GUARANTEE_NO_GET_INPUT();
+      return;
+    }
+    SET_OUTPUT(GATED_OUT, GET_INPUT(GATED_IN) + 1);
+  }
+
+  RESET() {
+    ticks = 0;
+  }
+};
+
+// ------------ SYSTEM --------------
+class Pairs: public System {
+public:
+  static constexpr size_t N = 4;
+  std::vector<Gated*> readers;
+
+  Pairs(size_t threads) {
+    for (size_t idx = 0; idx != N; ++idx) {
+      auto &source = addModule<Source>("src" + std::to_string(idx));
+      auto &reader = addModule<Gated>("gated" + std::to_string(idx));
+      reader.connect<GATED_IN, SRC_OUT>(source);
+      readers.push_back(&reader);
+    }
+    enableParallelSettle(threads, 1);
+    init();
+  }
+};
+
+int main() try {
+  Pairs serial(1);
+  Pairs parallel(2);
+  for (size_t cycle = 0; cycle != 1000; ++cycle) {
+    serial.step();
+    parallel.step();
+  }
+
+  bool ok = (parallel.statistics().levels == 2);
+  for (size_t idx = 0; idx != Pairs::N; ++idx) {
+    ok = ok && (serial.readers[idx]->getOutput<GATED_OUT>() == parallel.readers[idx]->getOutput<GATED_OUT>());
+  }
+
+  std::cout << "Levels: " << parallel.statistics().levels << '\n'
+	    << (ok ? "OK" : "FAILED") << '\n';
+  return ok ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,135 @@
+#include <iostream>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../rinku/rinku.h"
+
+// The scopes only inspect the monitored outputs that were reported as changed
+// while settling. Outputs that are set from outside (as the debugger's poke
+// does) must be recorded as well, including those of disabled modules and of
+// modules that guaranteed not to read their inputs. The history is compared
+// to that of a system settled on two threads, which inspects every monitored
+// signal on every sample.
+
+using namespace Rinku;
+
+// ------------ COUNTER --------------
+OUTPUT(CNT_OUT, 4);
+SIGNAL_LIST(CounterOutputs, CNT_OUT);
+
+class Counter: MODULE(CounterOutputs) {
+  signal_t value = 0;
+public:
+  EVENT_DRIVEN();
+
+  ON_CLOCK_RISING() {
+    value = (value + 1) & 3;
+    STATE_CHANGED();
+  }
+
+  UPDATE() {
+    SET_OUTPUT(CNT_OUT, value);
+  }
+
+  RESET() {
+    value = 0;
+  }
+};
+
+// ------------ CONSTANT --------------
+OUTPUT(CONST_OUT, 4);
+SIGNAL_LIST(ConstantOutputs, CONST_OUT);
+
+class Constant: MODULE(ConstantOutputs) {
+public:
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(CONST_OUT, 3);
+  }
+};
+
+// ------------ READER --------------
+INPUT(RD_IN, 4);
+OUTPUT(RD_OUT, 4);
+SIGNAL_LIST(ReaderInputs, RD_IN);
+SIGNAL_LIST(ReaderOutputs, RD_OUT);
+
+class Reader: MODULE(ReaderInputs, ReaderOutputs) {
+public:
+  EVENT_DRIVEN();
+
+  UPDATE() {
+    SET_OUTPUT(RD_OUT, GET_INPUT(RD_IN));
+  }
+};
+
+// ------------ SYSTEM --------------
+class Poked: public System {
+public:
+  Counter *counter;
+  Constant *constant;
+
+  Poked(size_t threads) {
+    counter = &addModule<Counter>("counter");
+    constant = &addModule<Constant>("constant");
+    auto &reader = addModule<Reader>("reader");
+    reader.connect<RD_IN, CONST_OUT>(*constant);
+
+    VcdScope &scope = addScope("scope");
+    scope.monitor(*counter);
+    scope.monitor(*constant);
+    scope.monitor(reader);
+    enableParallelSettle(threads);
+    init();
+  }
+
+  std::string history() {
+    std::string const vcd = this->vcd();
+    return vcd.substr(vcd.find("$scope"));
+  }
+};
+
+std::string run(size_t threads) {
+  Poked sys(threads);
+  sys.step();
+
+  // Poke and disable, then step while disabled
+  sys.counter->setOutput<CNT_OUT>(9);
+  sys.counter->enableUpdate(false);
+  sys.step();
+  sys.step();
+  sys.counter->enableUpdate(true);
+  sys.step();
+
+  // Disable first, then set the output
+  sys.counter->enableUpdate(false);
+  sys.counter->setOutput<CNT_OUT>(12);
+  sys.step();
+  sys.counter->enableUpdate(true);
+  sys.step();
+
+  // A module that guaranteed not to read its inputs, and its reader
+  sys.constant->setOutput<CONST_OUT>(5);
+  sys.constant->enableUpdate(false);
+  sys.step();
+  sys.step();
+  return sys.history();
+}
+
+int main() try {
+  std::string const watched = run(1);
+  std::string const sampled = run(2);
+
+  bool const ok = (watched == sampled) &&
+    watched.find("b1001 ") != std::string::npos &&
+    watched.find("b1100 ") != std::string::npos &&
+    watched.find("b101 \"") != std::string::npos &&
+    watched.find("b101 #") != std::string::npos;
+  
+  std::cout << (ok ? "OK" : "FAILED") << '\n';
+  if (!ok) std::cout << watched << "\n----\n" << sampled << '\n';
+  return ok ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+
+#define RINKU_REMOVE_MACRO_PREFIX
+#include "../rinku/rinku.h"
+#include "../rinku/util/bus.h"
+#include "../rinku/util/splitter.h"
+#include "../rinku/util/joiner.h"
+
+// Readers of a wire (a bus, splitter or joiner) read the drivers of the wire
+// directly. Poking the wire, the way the debugger does (set its output and
+// disable its updates), must still reach its readers, and the wire must read
+// back the poked value. Once it is enabled again, it follows its inputs.
+
+using namespace Rinku;
+using namespace Rinku::Util;
+
+// ------------ SOURCE --------------
+OUTPUT(SRC_OUT, 8);
+SIGNAL_LIST(SourceOutputs, SRC_OUT);
+
+class Source: MODULE(SourceOutputs) {
+public:
+  EVENT_DRIVEN();
+
+  UPDATE() {
+    GUARANTEE_NO_GET_INPUT();
+    SET_OUTPUT(SRC_OUT, 5);
+  }
+};
+
+// ------------ READER --------------
+INPUT(RD_IN, 8);
+INPUT(RD_BIT, 1);
+INPUT(RD_JOINED, 2);
+OUTPUT(RD_OUT, 8);
+OUTPUT(RD_BIT_OUT, 1);
+OUTPUT(RD_JOINED_OUT, 2);
+SIGNAL_LIST(ReaderInputs, RD_IN, RD_BIT, RD_JOINED);
+SIGNAL_LIST(ReaderOutputs, RD_OUT, RD_BIT_OUT, RD_JOINED_OUT);
+
+class Reader: MODULE(ReaderInputs, ReaderOutputs) {
+public:
+  EVENT_DRIVEN();
+
+  UPDATE() {
+    SET_OUTPUT(RD_OUT, GET_INPUT(RD_IN));
+    SET_OUTPUT(RD_BIT_OUT, GET_INPUT(RD_BIT));
+    SET_OUTPUT(RD_JOINED_OUT, GET_INPUT(RD_JOINED));
+  }
+};
+
+// ------------ SYSTEM --------------
+class Wires: public System {
+public:
+  Bus *bus;
+  Splitter<8> *split;
+  Joiner<2> *join;
+  Reader *reader;
+
+  Wires() {
+    auto &source = addModule<Source>("src");
+    bus = &addModule<Bus>("bus");
+    split = &addModule<Splitter<8>>("split");
+    join = &addModule<Joiner<2>>("join");
+    reader = &addModule<Reader>("reader");
+
+    bus->connect<BUS_DATA_IN, SRC_OUT>(source);
+    split->connect<SPLITTER_IN, BUS_DATA_OUT>(*bus);
+    join->connect<JOINER_IN_0, SPLITTER_OUT_0>(*split);
+    join->connect<JOINER_IN_1, SPLITTER_OUT_1>(*split);
+    reader->connect<RD_IN, BUS_DATA_OUT>(*bus);
+    reader->connect<RD_BIT, SPLITTER_OUT_2>(*split);
+    reader->connect<RD_JOINED, JOINER_OUT>(*join);
+
+    VcdScope &scope = addScope("scope");
+    scope.monitor(*reader);
+    scope.monitor<BUS_DATA_OUT>(*bus);
+    init();
+  }
+
+  bool expect(signal_t busOut, signal_t bit, signal_t joined) const {
+    return reader->getOutput<RD_OUT>() == busOut && bus->getOutput<BUS_DATA_OUT>() == busOut &&
+      reader->getOutput<RD_BIT_OUT>() == bit && split->getOutput<SPLITTER_OUT_2>() == bit &&
+      reader->getOutput<RD_JOINED_OUT>() == joined && join->getOutput<JOINER_OUT>() == joined;
+  }
+};
+
+// Sets an output and disables the module, as the debugger's poke does
+template <typename S, typename ModuleT>
+void poke(System &sys, ModuleT &m, signal_t value) {
+  m.template setOutput<S>(value);
+  m.enableUpdate(false);
+  sys.updateAll();
+}
+
+int main() try {
+  Wires sys;
+  bool ok = (sys.statistics().aliasedWires == 3) && sys.expect(5, 1, 1);
+  sys.step();
+
+  // 9 = 0b1001: bit 2 is 0, the low bits read 0b01
+  poke<BUS_DATA_OUT>(sys, *sys.bus, 9);
+  ok = ok && sys.expect(9, 0, 1);
+  sys.step();
+  ok = ok && sys.expect(9, 0, 1);
+
+  poke<SPLITTER_OUT_0>(sys, *sys.split, 0);
+  ok = ok && sys.expect(9, 0, 0);
+
+  poke<JOINER_OUT>(sys, *sys.join, 3);
+  ok = ok && sys.expect(9, 0, 3);
+  sys.step();
+
+  sys.bus->enableUpdate(true);
+  sys.split->enableUpdate(true);
+  sys.join->enableUpdate(true);
+  sys.step();
+  ok = ok && sys.expect(5, 1, 1);
+
+  // Setting the output of an enabled wire from outside lasts until it is
+  // updated again
+  Wires other;
+  other.bus->setOutput<BUS_DATA_OUT>(9);
+  ok = ok && other.bus->getOutput<BUS_DATA_OUT>() == 9;
+  other.updateAll();
+  ok = ok && other.expect(5, 1, 1);
+
+  // The poked values were recorded by the scope
+  std::string const vcd = sys.vcd();
+  ok = ok && vcd.find("b1001 ") != std::string::npos;
+
+  std::cout << (ok ? "OK" : "FAILED") << '\n';
+  return ok ? 0 : 1;
+
+} catch (Rinku::Error::Exception &err) {
+  std::cerr << err.what() << '\n';
+  return 1;
+}